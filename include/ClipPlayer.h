@@ -0,0 +1,52 @@
+// ClipPlayer.h
+// Playback of prerendered LED clips straight from flash.
+//
+// A clip is a byte array produced by tools/clip_render (a PROGMEM header for
+// the firmware, a .clip file on the host). Layout, little-endian:
+//
+//   'H' 'C' 'L' 'P' | version | flags | pixels (u16) | frames (u16) | frame ms (u16)
+//   then per frame: ops length (u16) | ops
+//
+// Each frame's ops (see FrameCodec.h: SKIP / RUN / LITERAL) are coded against
+// the previous frame, the first one against black. The player keeps only a
+// byte offset into the clip and decodes one frame at a time into the target
+// buffer, so the clip is never copied into RAM. On the ESP32, PROGMEM data is
+// memory-mapped flash and is read in place; on the host the clip is mmap'ed.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <FastLED.h>
+
+#define CLIP_MAGIC0 'H'
+#define CLIP_MAGIC1 'C'
+#define CLIP_MAGIC2 'L'
+#define CLIP_MAGIC3 'P'
+#define CLIP_VERSION 1
+#define CLIP_HEADER_BYTES 12
+
+struct ClipPlayer {
+    const uint8_t *clip = nullptr;
+    uint32_t size = 0;
+    uint16_t pixels = 0;
+    uint16_t frameCount = 0;
+    uint16_t frameMs = 0;
+
+    // Read position: byte offset and index of the next frame
+    uint32_t offset = CLIP_HEADER_BYTES;
+    uint16_t frame = 0;
+    uint32_t previousMillis = 0;
+    bool playing = false;
+    bool loop = true;
+};
+
+// Validate the clip header and start at frame 0. Returns false (and leaves
+// the player stopped) when the data isn't a clip this build understands.
+bool clipPlayerStart(ClipPlayer &player, const uint8_t *clip, uint32_t size, bool loop, uint32_t now);
+void clipPlayerStop(ClipPlayer &player);
+
+// Decode the next frame into leds[start .. start + pixels - 1] when it is due.
+// Returns true when a frame was applied. A looping clip clears the range and
+// starts over after its last frame; a one-shot clip stops there.
+bool clipPlayerUpdate(ClipPlayer &player, CRGB *leds, int start, uint32_t now);
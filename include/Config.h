@@ -4,49 +4,112 @@
 #include <FastLED.h>
 
 // LED Strip Configuration
+// NUM_LEDS is the physical strip length; effects draw into a compact logical
+// buffer of LOGICAL_LEDS pixels that the topology table below maps onto it.
+// The strip, segment and timing settings in this file describe the standard
+// table profile; other tables are defined in Profiles.h.
 #define NUM_LEDS 110
 #define DATA_PIN 4
 #define COLOR_ORDER GRB
 
-// LED Segments
+// Optional second data pin: the strip is cut at OUTPUT2_FIRST_LED and the rest is
+// wired to DATA_PIN2, so the dead run in front of the cut isn't clocked out.
+// #define DATA_PIN2 5
+// #define OUTPUT2_FIRST_LED 100
+
+// LED Segments (logical indices, packed in this order)
+#define WIND_LED_COUNT 6
+#define SOLAR_LED_COUNT 6
+#define ELECTRICITY_PRODUCTION_LED_COUNT 5
+#define HYDROGEN_PRODUCTION_LED_COUNT 6
+#define HYDROGEN_TRANSPORT_LED_COUNT 7
+#define HYDROGEN_STORAGE1_LED_COUNT 2
+#define HYDROGEN_STORAGE2_LED_COUNT 6
+#define HYDROGEN_CONSUMPTION_LED_COUNT 6
+#define ELECTRICITY_TRANSPORT_LED_COUNT 9
+#define STORAGE_TRANSPORT_LED_COUNT 5
+#define STORAGE_POWERSTATION_LED_COUNT 6
+#define FABRICATION_LED_COUNT 10
+#define INFO_LED_COUNT 7
+
 #define WIND_LED_START 0
-#define WIND_LED_END 5
-#define SOLAR_LED_START 6
-#define SOLAR_LED_END 11
-#define ELECTRICITY_PRODUCTION_LED_START 12
-#define ELECTRICITY_PRODUCTION_LED_END 16
-
-#define HYDROGEN_PRODUCTION_LED_START 17
-#define HYDROGEN_PRODUCTION_LED_END 22
-#define HYDROGEN_TRANSPORT_LED_START 23
-#define HYDROGEN_TRANSPORT_LED_MID 28
-#define HYDROGEN_TRANSPORT_LED_END 29
-#define HYDROGEN_STORAGE1_LED_START 34
-#define HYDROGEN_STORAGE1_LED_END 35
-#define HYDROGEN_STORAGE2_LED_START 40
-#define HYDROGEN_STORAGE2_LED_END 45
-
-#define HYDROGEN_CONSUMPTION_LED_START 46
-#define HYDROGEN_CONSUMPTION_LED_END 51
-#define FABRICATION_LED_START 100
-#define FABRICATION_LED_END 110
-
-#define ELECTRICITY_TRANSPORT_LED_START 52
-#define ELECTRICITY_TRANSPORT_LED_END 60
-
-#define STORAGE_TRANSPORT_LED_START 61
-#define STORAGE_TRANSPORT_LED_END 65
-#define STORAGE_POWERSTATION_LED_START 66
-#define STORAGE_POWERSTATION_LED_END 71
+#define WIND_LED_END (WIND_LED_START + WIND_LED_COUNT - 1)
+#define SOLAR_LED_START (WIND_LED_END + 1)
+#define SOLAR_LED_END (SOLAR_LED_START + SOLAR_LED_COUNT - 1)
+#define ELECTRICITY_PRODUCTION_LED_START (SOLAR_LED_END + 1)
+#define ELECTRICITY_PRODUCTION_LED_END (ELECTRICITY_PRODUCTION_LED_START + ELECTRICITY_PRODUCTION_LED_COUNT - 1)
+
+#define HYDROGEN_PRODUCTION_LED_START (ELECTRICITY_PRODUCTION_LED_END + 1)
+#define HYDROGEN_PRODUCTION_LED_END (HYDROGEN_PRODUCTION_LED_START + HYDROGEN_PRODUCTION_LED_COUNT - 1)
+#define HYDROGEN_TRANSPORT_LED_START (HYDROGEN_PRODUCTION_LED_END + 1)
+// consumption starts once the gas reaches this LED (standard profile)
+#define HYDROGEN_TRANSPORT_LED_MID (HYDROGEN_TRANSPORT_LED_START + 5)
+#define HYDROGEN_TRANSPORT_LED_END (HYDROGEN_TRANSPORT_LED_START + HYDROGEN_TRANSPORT_LED_COUNT - 1)
+#define HYDROGEN_STORAGE1_LED_START (HYDROGEN_TRANSPORT_LED_END + 1)
+#define HYDROGEN_STORAGE1_LED_END (HYDROGEN_STORAGE1_LED_START + HYDROGEN_STORAGE1_LED_COUNT - 1)
+#define HYDROGEN_STORAGE2_LED_START (HYDROGEN_STORAGE1_LED_END + 1)
+#define HYDROGEN_STORAGE2_LED_END (HYDROGEN_STORAGE2_LED_START + HYDROGEN_STORAGE2_LED_COUNT - 1)
+
+#define HYDROGEN_CONSUMPTION_LED_START (HYDROGEN_STORAGE2_LED_END + 1)
+#define HYDROGEN_CONSUMPTION_LED_END (HYDROGEN_CONSUMPTION_LED_START + HYDROGEN_CONSUMPTION_LED_COUNT - 1)
+
+#define ELECTRICITY_TRANSPORT_LED_START (HYDROGEN_CONSUMPTION_LED_END + 1)
+#define ELECTRICITY_TRANSPORT_LED_END (ELECTRICITY_TRANSPORT_LED_START + ELECTRICITY_TRANSPORT_LED_COUNT - 1)
+
+#define STORAGE_TRANSPORT_LED_START (ELECTRICITY_TRANSPORT_LED_END + 1)
+#define STORAGE_TRANSPORT_LED_END (STORAGE_TRANSPORT_LED_START + STORAGE_TRANSPORT_LED_COUNT - 1)
+#define STORAGE_POWERSTATION_LED_START (STORAGE_TRANSPORT_LED_END + 1)
+#define STORAGE_POWERSTATION_LED_END (STORAGE_POWERSTATION_LED_START + STORAGE_POWERSTATION_LED_COUNT - 1)
+
+#define FABRICATION_LED_START (STORAGE_POWERSTATION_LED_END + 1)
+#define FABRICATION_LED_END (FABRICATION_LED_START + FABRICATION_LED_COUNT - 1)
 
 // Info LEDs
-#define WIND_INFO_LED 62
-#define ELECTROLYSER_INFO_LED 63
-#define HYDROGEN_PRODUCTION_INFO_LED 64
-#define HYDROGEN_STORAGE_INFO_LED 65
-#define HYDROGEN_CONSUMPTION_INFO_LED 66
-#define ELECTRICITY_TRANSPORT_INFO_LED 67
-#define STREET_LED 68
+#define INFO_LED_START (FABRICATION_LED_END + 1)
+#define WIND_INFO_LED (INFO_LED_START + 0)
+#define ELECTROLYSER_INFO_LED (INFO_LED_START + 1)
+#define HYDROGEN_PRODUCTION_INFO_LED (INFO_LED_START + 2)
+#define HYDROGEN_STORAGE_INFO_LED (INFO_LED_START + 3)
+#define HYDROGEN_CONSUMPTION_INFO_LED (INFO_LED_START + 4)
+#define ELECTRICITY_TRANSPORT_INFO_LED (INFO_LED_START + 5)
+#define STREET_LED (INFO_LED_START + 6)
+
+#define LOGICAL_LEDS (INFO_LED_START + INFO_LED_COUNT)
+
+// Physical wiring: first strip index of each logical segment
+// (unused stretches: 30-33, 36-39, 72-99)
+#define WIND_PHYS_START 0
+#define SOLAR_PHYS_START 6
+#define ELECTRICITY_PRODUCTION_PHYS_START 12
+#define HYDROGEN_PRODUCTION_PHYS_START 17
+#define HYDROGEN_TRANSPORT_PHYS_START 23
+#define HYDROGEN_STORAGE1_PHYS_START 34
+#define HYDROGEN_STORAGE2_PHYS_START 40
+#define HYDROGEN_CONSUMPTION_PHYS_START 46
+#define ELECTRICITY_TRANSPORT_PHYS_START 52
+#define STORAGE_TRANSPORT_PHYS_START 61
+#define STORAGE_POWERSTATION_PHYS_START 66
+#define FABRICATION_PHYS_START 100
+// The info LEDs share pixels 62-68 with storage transport / powerstation and win there
+#define INFO_PHYS_START 62
+
+// Topology: { logical start, physical start, length }. Later runs win where
+// runs overlap on the strip. Re-wiring a table means editing this list.
+#define TOPOLOGY_RUNS { \
+    { WIND_LED_START, WIND_PHYS_START, WIND_LED_COUNT }, \
+    { SOLAR_LED_START, SOLAR_PHYS_START, SOLAR_LED_COUNT }, \
+    { ELECTRICITY_PRODUCTION_LED_START, ELECTRICITY_PRODUCTION_PHYS_START, ELECTRICITY_PRODUCTION_LED_COUNT }, \
+    { HYDROGEN_PRODUCTION_LED_START, HYDROGEN_PRODUCTION_PHYS_START, HYDROGEN_PRODUCTION_LED_COUNT }, \
+    { HYDROGEN_TRANSPORT_LED_START, HYDROGEN_TRANSPORT_PHYS_START, HYDROGEN_TRANSPORT_LED_COUNT }, \
+    { HYDROGEN_STORAGE1_LED_START, HYDROGEN_STORAGE1_PHYS_START, HYDROGEN_STORAGE1_LED_COUNT }, \
+    { HYDROGEN_STORAGE2_LED_START, HYDROGEN_STORAGE2_PHYS_START, HYDROGEN_STORAGE2_LED_COUNT }, \
+    { HYDROGEN_CONSUMPTION_LED_START, HYDROGEN_CONSUMPTION_PHYS_START, HYDROGEN_CONSUMPTION_LED_COUNT }, \
+    { ELECTRICITY_TRANSPORT_LED_START, ELECTRICITY_TRANSPORT_PHYS_START, ELECTRICITY_TRANSPORT_LED_COUNT }, \
+    { STORAGE_TRANSPORT_LED_START, STORAGE_TRANSPORT_PHYS_START, STORAGE_TRANSPORT_LED_COUNT }, \
+    { STORAGE_POWERSTATION_LED_START, STORAGE_POWERSTATION_PHYS_START, STORAGE_POWERSTATION_LED_COUNT }, \
+    { FABRICATION_LED_START, FABRICATION_PHYS_START, FABRICATION_LED_COUNT }, \
+    { INFO_LED_START, INFO_PHYS_START, INFO_LED_COUNT }, \
+}
 
 // Colors
 #define WIND_COLOR_ACTIVE CRGB(255, 255, 0)
@@ -55,6 +118,11 @@
 #define HYDROGEN_CONSUMPTION_COLOR_ACTIVE CRGB(0, 255, 0)
 #define ELECTRICITY_TRANSPORT_COLOR_ACTIVE CRGB(255, 255, 0)
 
+// Fabrication fire shape: cooling per step, spark chance 0..255. fireLeds takes
+// its constructor defaults from these (fireEffect.h), so include Config.h first.
+#define FIRE_COOLING 55
+#define FIRE_SPARKING 120
+
 // Timing
 #define LED_DELAY 200
 #define LED_DELAY2 100
@@ -64,11 +132,89 @@
 #define BUTTON_PIN 0
 #define BUTTON_LED_PIN 2
 #define STREET_LED_PIN 14
+// Table profile strap (Profiles.h): pulled LOW at boot selects the second profile
+#define PROFILE_STRAP_PIN 27
 
 // Relays
 #define WIND_TURBINE_RELAY_PIN 12
 #define ELECTROLYSER_RELAY_PIN 13
 
+// Effect pool capacities (statically allocated in SystemState)
+#define MAX_FADE_EFFECTS 4
+#define MAX_FIRE_EFFECTS 2
+#define MAX_GAS_FLOW_EFFECTS 4
+
+// Hydrogen gas flow (particle system) at rated production: speed in 1/256 LED per 20 ms step, density 0..255
+// 26/256 LED per step is roughly the pace of the LED_DELAY chasers
+#define HYDROGEN_FLOW_SPEED 26
+#define HYDROGEN_FLOW_DENSITY 80
+#define FADE_DURATION_MS 2000
+
+// Hydrogen system model (demo time: one second on the table stands for a minute)
+#define MODEL_STEP_MS 50
+#define WIND_RATED_KW 50
+#define WIND_RAMP_MS 3000
+#define ELECTROLYSER_RATED_KW 40
+#define H2_GPS_PER_KW 0.3
+#define H2_RATED_GPS (ELECTROLYSER_RATED_KW * H2_GPS_PER_KW)
+#define H2_CONSUMPTION_GPS 4
+#define STORAGE_CAPACITY_G 80
+#define STORAGE_DRAIN_GPS 4
+
+// Output stage: gamma (x100), global brightness and per-batch white balance.
+// Each zone is { start, end, white R, white G, white B }; later zones override earlier ones.
+#define OUTPUT_GAMMA_X100 220
+#define OUTPUT_BRIGHTNESS 255
+#define OUTPUT_MAX_ZONES 4
+#define OUTPUT_ZONE_DEFAULTS { { 0, NUM_LEDS - 1, 255, 255, 255 } }
+
+// Frame budget governor (FrameGovernor.h): step effects down to cheaper variants
+// while loop() averages more than GOVERNOR_BUDGET_US per pass, restore them once
+// the average has stayed below GOVERNOR_RESTORE_PERCENT of it for GOVERNOR_RESTORE_MS
+#define GOVERNOR_BUDGET_US 10000
+#define GOVERNOR_RESTORE_PERCENT 70
+#define GOVERNOR_HOLD_MS 500
+#define GOVERNOR_RESTORE_MS 3000
+#define GOVERNOR_FIRE_WAIT_MS 100   // fabrication fire step below full quality (default FIRE_WAIT_MS)
+
+// Serial frame mirror (tools/frame_viewer). Set FRAME_MIRROR to 1 to stream frames;
+// Serial debug prints are tolerated, the viewer resynchronises on the packet header.
+#ifndef FRAME_MIRROR
+#define FRAME_MIRROR 0
+#endif
+#define FRAME_MIRROR_INTERVAL_MS 33
+#define FRAME_MIRROR_KEYFRAME_EVERY 30
+// UART TX ring buffer set up before Serial.begin() when mirroring. Without it
+// availableForWrite() is bounded by the 128-byte hardware FIFO, below a keyframe.
+#define FRAME_MIRROR_TX_BUFFER 1024
+
+// Idle attract loop: with IDLE_CLIP set to 1 the prerendered clip in
+// include/clips/IdleClip.h (tools/clip_render) plays from flash while the table
+// waits for the button, instead of the live wind animation.
+#ifndef IDLE_CLIP
+#define IDLE_CLIP 0
+#endif
+
+// Event trace (Trace.h): ring buffer of stage on/off changes, timer starts and
+// show() spans, dumped as Chrome trace JSON with 't' over Serial. TRACE_EVENTS
+// picks what is recorded (0 compiles the trace out):
+//   1 stage flags on/off, 2 timer starts, 4 show() spans; 7 records everything.
+// Stage changes have a ring of their own and keep the last runs whatever
+// else is on. Timer starts (the chasers re-arm every step) and show() spans
+// share the other ring, which only covers the last few seconds.
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS 0
+#endif
+#define TRACE_STAGE_CAPACITY 256
+#define TRACE_CAPACITY 1024
+
+// Host soak test (tools/soak): pixels of guard space behind state.leds that
+// must stay black, so writes past the largest profile's buffer are caught.
+// Leave at 0 for the board.
+#ifndef LED_GUARD_PIXELS
+#define LED_GUARD_PIXELS 0
+#endif
+
 // General timers
 #define WIND_TIME_MS 42000U
 #define RUN_TIME_MS 90000U
@@ -0,0 +1,96 @@
+// Coroutine.h
+// Stackless coroutines (protothreads) for writing effects as sequential code.
+//
+// A coroutine is a plain `Coroutine` value stored in SystemState plus a
+// function whose body sits between CO_BEGIN and CO_END:
+//
+//     void update(SystemState &state, Timers &timers) {
+//         const uint32_t now = millis();
+//         Coroutine &co = state.someTask;
+//         CO_BEGIN(co, now);
+//         for (;;) {
+//             CO_WAIT_UNTIL(co, state.someFlag);
+//             ... step the chaser ...
+//             CO_SLEEP(co, now, LED_DELAY);
+//         }
+//         CO_END(co);
+//     }
+//
+// The resume point is the source line of the last suspension (Duff's device
+// over a switch), so the coroutine needs 8 bytes and no stack of its own.
+// While it sleeps, CO_BEGIN returns after one comparison.
+//
+// Rules that come with the switch: locals do not survive a suspension (keep
+// cursors in SystemState), use at most one CO_* macro per source line, do not
+// suspend inside a nested switch, and the enclosing function returns void.
+
+#pragma once
+
+#include <stdint.h>
+
+struct Coroutine {
+    uint16_t line = 0;        // resume point, 0 = start, CO_FINISHED after CO_END
+    bool sleeping = false;
+    uint32_t wakeAt = 0;
+};
+
+static const uint16_t CO_FINISHED = 0xFFFF;
+
+// CO_WAIT_UNTIL deliberately falls into its own case label
+#if defined(__GNUC__) && __GNUC__ >= 7
+#define CO_FALLTHROUGH __attribute__((fallthrough))
+#else
+#define CO_FALLTHROUGH ((void)0)
+#endif
+
+// Restart from the top on the next call (effects call this from reset())
+inline void coReset(Coroutine &co) {
+    co = Coroutine();
+}
+
+inline bool coFinished(const Coroutine &co) {
+    return co.line == CO_FINISHED;
+}
+
+// False while the coroutine sleeps or after it has finished
+inline bool coReady(const Coroutine &co, uint32_t now) {
+    if (co.line == CO_FINISHED) return false;
+    return !co.sleeping || (int32_t)(now - co.wakeAt) >= 0;
+}
+
+#define CO_BEGIN(co, now)                    \
+    if (!coReady((co), (now))) return;       \
+    (co).sleeping = false;                   \
+    switch ((co).line) {                     \
+    case 0:
+
+// Suspend for ms milliseconds; the coroutine is not resumed before then
+#define CO_SLEEP(co, now, ms)                \
+    do {                                     \
+        (co).wakeAt = (now) + (ms);          \
+        (co).sleeping = true;                \
+        (co).line = __LINE__;                \
+        return;                              \
+    case __LINE__:;                          \
+    } while (0)
+
+// Suspend until the next call
+#define CO_YIELD(co)                         \
+    do {                                     \
+        (co).line = __LINE__;                \
+        return;                              \
+    case __LINE__:;                          \
+    } while (0)
+
+// Suspend until cond holds (re-checked on every call)
+#define CO_WAIT_UNTIL(co, cond)              \
+    do {                                     \
+        (co).line = __LINE__;                \
+        CO_FALLTHROUGH;                      \
+    case __LINE__:                           \
+        if (!(cond)) return;                 \
+    } while (0)
+
+#define CO_END(co)                           \
+    }                                        \
+    (co).line = CO_FINISHED
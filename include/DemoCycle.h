@@ -0,0 +1,29 @@
+// DemoCycle.h
+// The button-driven demo cycle: a press starts a run (wind, then the whole
+// hydrogen chain), the wind stops after WIND_TIME_MS and everything is reset
+// after RUN_TIME_MS, after which the button is armed again.
+//
+// Everything the cycle keeps lives in the SystemState/Timers it is given, so
+// the host tools can run several instances side by side (tools/soak).
+
+#pragma once
+
+#include "SystemState.h"
+
+// Take the effect instances used by the flow from the state's pools and reset every stage
+void demoCycleBegin(SystemState &state, Timers &timers);
+// Debounced button check; starts a run, and ends it after RUN_TIME_MS
+void checkButtonState(SystemState &state, Timers &timers);
+// Reset every stage, the hydrogen model and the button/run timers
+void resetAllVariables(SystemState &state, Timers &timers);
+// Drive the relay outputs from the stage flags
+void updateRelays(const SystemState &state);
+
+// Called before the effects each pass; returning true means something else
+// drew state.leds this pass and the effects are skipped (the idle clip)
+typedef bool (*DemoLedOwner)(SystemState &state);
+
+// One pass of the cycle as loop() runs it: button, model, effects, relays,
+// output stage and show(), with the pass cost handed to the frame governor.
+// The host tools call this too, so they run exactly what the board runs.
+void demoCyclePass(SystemState &state, Timers &timers, DemoLedOwner ledOwner = nullptr);
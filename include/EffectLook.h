@@ -0,0 +1,35 @@
+// EffectLook.h
+// Look-and-feel settings the effects read at run time: stage colours, chaser
+// step times and the fabrication fire's shape.
+//
+// The defaults are the Config.h colours and fire settings; a chaser delay of
+// 0 means "the active profile's ledDelay / ledDelay2". The firmware never
+// changes them. tools/batch_render sets them per render job so variants can
+// be compared without rebuilding.
+
+#pragma once
+
+#include <stdint.h>
+#include <FastLED.h>
+#include "Config.h"
+
+struct EffectLook {
+    CRGB windColor = WIND_COLOR_ACTIVE;
+    CRGB hydrogenProductionColor = HYDROGEN_PRODUCTION_COLOR_ACTIVE;
+    CRGB hydrogenStorageColor = HYDROGEN_STORAGE_COLOR_ACTIVE;
+    CRGB hydrogenConsumptionColor = HYDROGEN_CONSUMPTION_COLOR_ACTIVE;
+    CRGB electricityTransportColor = ELECTRICITY_TRANSPORT_COLOR_ACTIVE;
+
+    // Chaser step times in ms, 0 = profile default
+    uint16_t ledDelay = 0;
+    uint16_t ledDelay2 = 0;
+
+    // fireLeds heat model: cooling per step and spark chance (0..255)
+    uint8_t fireCooling = FIRE_COOLING;
+    uint8_t fireSparking = FIRE_SPARKING;
+};
+
+// Step time for a chaser: the override if one is set, else the profile's
+inline uint32_t lookDelay(uint16_t override, uint32_t profileDelay) {
+    return override ? override : profileDelay;
+}
@@ -0,0 +1,100 @@
+// EffectPool.h
+// Fixed-capacity, statically allocated pool (arena) for effect objects.
+//
+// Effects that carry their own animation phase (fades, fires, ...) live in a
+// pool owned by `SystemState` instead of on the heap. Callers keep an
+// `EffectHandle` rather than a raw pointer; a handle goes stale when its slot
+// is released, so `get()` on an old handle returns nullptr instead of aliasing
+// whatever effect reused the slot.
+
+#pragma once
+
+#include <stdint.h>
+#include <new>
+#include <utility>
+
+struct EffectHandle {
+    uint8_t index = 0xFF;
+    uint8_t generation = 0;
+
+    bool valid() const { return index != 0xFF; }
+};
+
+template <typename T, uint8_t N>
+class EffectPool {
+public:
+    static_assert(N > 0 && N < 0xFF, "EffectPool capacity must be 1..254");
+
+    EffectPool() {
+        for (uint8_t i = 0; i < N; ++i) {
+            used[i] = false;
+            generation[i] = 0;
+        }
+    }
+
+    ~EffectPool() { releaseAll(); }
+
+    EffectPool(const EffectPool &) = delete;
+    EffectPool &operator=(const EffectPool &) = delete;
+
+    // Construct a new effect in a free slot. Returns an invalid handle when the
+    // pool is exhausted (capacity is a compile-time setting in Config.h).
+    template <typename... Args>
+    EffectHandle acquire(Args &&...args) {
+        EffectHandle h;
+        for (uint8_t i = 0; i < N; ++i) {
+            if (!used[i]) {
+                new (slot(i)) T(std::forward<Args>(args)...);
+                used[i] = true;
+                h.index = i;
+                h.generation = generation[i];
+                return h;
+            }
+        }
+        return h;
+    }
+
+    // Destroy the effect and invalidate every handle that refers to it.
+    void release(EffectHandle &h) {
+        if (T *obj = get(h)) {
+            obj->~T();
+            used[h.index] = false;
+            ++generation[h.index];
+        }
+        h = EffectHandle();
+    }
+
+    void releaseAll() {
+        for (uint8_t i = 0; i < N; ++i) {
+            if (used[i]) {
+                slot(i)->~T();
+                used[i] = false;
+                ++generation[i];
+            }
+        }
+    }
+
+    T *get(const EffectHandle &h) {
+        if (h.index >= N || !used[h.index] || generation[h.index] != h.generation) return nullptr;
+        return slot(h.index);
+    }
+
+    uint8_t inUse() const {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < N; ++i) n += used[i] ? 1 : 0;
+        return n;
+    }
+
+    static constexpr uint8_t capacity() { return N; }
+
+private:
+    T *slot(uint8_t i) { return reinterpret_cast<T *>(&storage[i]); }
+
+    struct alignas(T) Slot {
+        uint8_t bytes[sizeof(T)];
+    };
+
+    Slot storage[N];
+    bool used[N];
+    uint8_t generation[N];
+};
@@ -0,0 +1,84 @@
+// FrameCodec.h
+// Packet format for mirroring LED frames over a byte stream (UART, pty).
+//
+// Packet:  A5 5A | type | seq | pixels (u16 LE) | payload length (u16 LE) | payload | Fletcher-16 (u16 LE)
+// The checksum covers everything from `type` to the end of the payload.
+//
+// Keyframes ('K') are coded against an all-black frame, deltas ('D') against
+// the previous frame in the stream. The payload is a list of ops; the top two
+// bits of each op byte give the kind and the low six bits hold count - 1:
+//   00 SKIP     count pixels unchanged
+//   01 RUN      count pixels of one colour, followed by R G B
+//   10 LITERAL  count pixels, followed by count x R G B
+//
+// Pure C++ (no Arduino/FastLED types) so the host viewer can share it.
+// Pixels are passed as packed R,G,B bytes, which is CRGB's memory layout.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FRAME_SYNC0 0xA5
+#define FRAME_SYNC1 0x5A
+#define FRAME_TYPE_KEY 'K'
+#define FRAME_TYPE_DELTA 'D'
+#define FRAME_HEADER_BYTES 8
+#define FRAME_TRAILER_BYTES 2
+// Worst case payload: every pixel a literal, plus one op byte per 64 pixels
+#define FRAME_MAX_PAYLOAD(pixels) ((pixels) * 3 + ((pixels) + 63) / 64)
+#define FRAME_MAX_PACKET(pixels) (FRAME_HEADER_BYTES + FRAME_MAX_PAYLOAD(pixels) + FRAME_TRAILER_BYTES)
+#define FRAME_DECODER_BUFFER(pixels) (FRAME_MAX_PAYLOAD(pixels) + FRAME_TRAILER_BYTES)
+
+// Encode one packet. prev == nullptr produces a keyframe. Returns the packet
+// length, or 0 when it doesn't fit into outCapacity.
+size_t frameEncode(const uint8_t *pixels, const uint8_t *prev, uint16_t count, uint8_t seq,
+                   uint8_t *out, size_t outCapacity);
+
+// Incremental decoder: feed it bytes as they arrive; it resynchronises on the
+// sync bytes and drops packets with a bad checksum. Deltas that don't follow
+// the last applied packet are ignored until the next keyframe.
+class FrameStreamDecoder {
+public:
+    // pixels: caller-owned buffer of capacity x 3 bytes that holds the decoded frame
+    // packetBuffer: caller-owned scratch of FRAME_DECODER_BUFFER(capacity) bytes
+    FrameStreamDecoder(uint8_t *pixels, uint16_t capacity, uint8_t *packetBuffer);
+
+    // Returns true when this byte completed a frame that was applied to the buffer
+    bool feed(uint8_t byte);
+
+    uint16_t pixelCount() const { return count; }
+    uint32_t framesDecoded() const { return frames; }
+    uint32_t packetsDropped() const { return dropped; }
+    uint32_t bytesInLastPacket() const { return lastPacketBytes; }
+
+private:
+    bool applyPayload();
+
+    uint8_t *pixels;
+    uint16_t capacity;
+    uint16_t count;
+
+    uint8_t header[FRAME_HEADER_BYTES];
+    uint8_t *payload;
+    uint16_t payloadLength;
+    uint16_t received;
+    uint8_t phase;
+    uint8_t expectedSeq;
+    bool synced;
+
+    uint32_t frames;
+    uint32_t dropped;
+    uint32_t lastPacketBytes;
+};
+
+uint16_t frameChecksum(const uint8_t *data, size_t length);
+
+// The op list on its own (no header or checksum), shared with the clip format
+// (ClipPlayer.h). Encodes pixels against prev (nullptr = black) into out;
+// false when it doesn't fit.
+bool frameEncodeOps(const uint8_t *pixels, const uint8_t *prev, uint16_t count,
+                    uint8_t *out, size_t outCapacity, size_t *length);
+// Apply an op list to count pixels in place; false when the ops are malformed
+// or address pixels past count.
+bool frameApplyOps(const uint8_t *ops, size_t length, uint8_t *pixels, uint16_t count);
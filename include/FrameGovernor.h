@@ -0,0 +1,46 @@
+// FrameGovernor.h
+// Frame budget governor: keeps loop() inside its time budget when many
+// stages are active at once.
+//
+// loop() reports what each pass cost (micros). The governor keeps a running
+// average and steps the quality level down when the average stays above
+// GOVERNOR_BUDGET_US, and back up once it has been below
+// GOVERNOR_RESTORE_PERCENT of the budget for GOVERNOR_RESTORE_MS. Each level
+// keeps the cheaper variants of the ones before it:
+//   QUALITY_FULL     everything as designed
+//   QUALITY_REDUCED  fire updates every GOVERNOR_FIRE_WAIT_MS, gas packets
+//                    drawn on the nearest LED instead of anti-aliased
+//   QUALITY_MINIMAL  frames whose logical pixels did not change skip the
+//                    output stage and FastLED.show()
+// Effects read state.governor.level; the numbers are printed with 's' over
+// Serial (see handleSerialCommands() in main.cpp).
+
+#pragma once
+
+#include <stdint.h>
+#include "Config.h"
+
+static const uint8_t QUALITY_FULL = 0;
+static const uint8_t QUALITY_REDUCED = 1;
+static const uint8_t QUALITY_MINIMAL = 2;
+
+struct FrameGovernor {
+    uint8_t level = QUALITY_FULL;
+    uint32_t lastChangeMillis = 0;
+
+    // Frame cost in microseconds: running average (1/8 weight for the newest
+    // frame) and the worst frame since the last report
+    uint32_t averageUs = 0;
+    uint32_t worstUs = 0;
+
+    uint32_t frames = 0;
+    uint32_t overruns = 0;       // frames over GOVERNOR_BUDGET_US
+    uint32_t downgrades = 0;
+    uint32_t upgrades = 0;
+};
+
+// Account one loop pass that took costUs; may change the level
+void frameGovernorUpdate(FrameGovernor &governor, uint32_t costUs, uint32_t now);
+// Print level and frame cost figures; resets the worst-frame figure
+void frameGovernorPrint(FrameGovernor &governor);
+const char *frameGovernorLevelName(uint8_t level);
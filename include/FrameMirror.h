@@ -0,0 +1,37 @@
+// FrameMirror.h
+// Optional live mirror of the logical LED frame over Serial (see FrameCodec.h for the
+// packet format and tools/frame_viewer for the host side).
+//
+// Only pixels changed since the last sent frame are transmitted, delta and
+// run-length coded, with a keyframe every FRAME_MIRROR_KEYFRAME_EVERY packets
+// so a viewer that joins late or drops bytes recovers. When the UART TX buffer
+// can't take a delta the frame is skipped rather than blocking loop(); a
+// keyframe is always written, otherwise every later packet would stay a
+// keyframe and a busy animation would never get one through.
+
+#pragma once
+
+#include <stdint.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "FrameCodec.h"
+#include "Profiles.h"
+
+struct FrameMirror {
+    bool enabled = true;
+    uint8_t seq = 0;
+    uint16_t packetsSinceKey = FRAME_MIRROR_KEYFRAME_EVERY;
+    uint32_t previousMillis = 0;
+    uint32_t framesSent = 0;
+    uint32_t framesSkipped = 0;
+
+    // Last frame the viewer received (the base for the next delta)
+    CRGB sent[kMaxLogicalLeds];
+    uint8_t packet[FRAME_MAX_PACKET(kMaxLogicalLeds)];
+};
+
+static_assert(FRAME_MAX_PACKET(kMaxLogicalLeds) <= FRAME_MIRROR_TX_BUFFER,
+              "FRAME_MIRROR_TX_BUFFER must hold a keyframe of the largest profile");
+
+// Send the first count leds if the mirror interval has elapsed and something changed
+void frameMirrorSend(FrameMirror &mirror, const CRGB *leds, uint16_t count);
@@ -7,7 +7,8 @@
 // LED helpers that operate on the system state's LED buffer
 void setPixelSafe(SystemState &state, int idx, const CRGB &col);
 void clearSegment(SystemState &state, int start, int end);
-// Run a quick LED test by lighting each LED in sequence (from 0 to NUM_LEDS-1)
+// Run a quick LED test by lighting each logical LED in sequence (from 0 to the profile's logicalLeds-1);
+// each one lights its mapped strip pixel, so this checks the wiring and the topology table
 // delayMs is the milliseconds to wait between steps (default 20ms)
 void testAllLeds(SystemState &state, uint16_t delayMs = 500);
 
@@ -0,0 +1,17 @@
+// MemoryReport.h
+// Memory and stack high-water report, printed over Serial on request
+// (send 'm'; see handleSerialCommands() in main.cpp).
+//
+// Static: sizes of SystemState and its parts (framebuffer, output stage,
+// effect pools, ...), which are fixed at compile time.
+// Heap: on the ESP32 the free / minimum-ever-free / largest-block figures of
+// the IDF heap; in the host build the tracking operator new/delete in
+// tools/host/HostArduino.cpp (bytes in use, peak, allocation count).
+// Stack: high-water marks of the Arduino loop task and the idle tasks on the
+// board; on the host the deepest use of the painted main-thread stack.
+
+#pragma once
+
+#include "SystemState.h"
+
+void memoryReportPrint(const SystemState &state, const Timers &timers);
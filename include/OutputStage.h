@@ -0,0 +1,70 @@
+// OutputStage.h
+// Final colour stage between the effects' framebuffer and the LED strip.
+//
+// Gamma, per-zone white balance and global brightness are folded into one
+// lookup table per zone and channel. Tables are rebuilt only when a setting
+// changes; per frame the stage does one table lookup per channel while copying
+// the logical `SystemState::leds` through the active profile's topology map
+// (Topology.h, Profiles.h) into the physical buffer FastLED transmits. Effects keep writing
+// linear colours and never see the corrected values, so dim trails and
+// partially faded pixels aren't corrected twice.
+
+#pragma once
+
+#include <stdint.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "Topology.h"
+#include "Profiles.h"
+
+// A run of physical LEDs from one batch that shares a white point
+struct OutputZone {
+    int start;
+    int end;
+    uint8_t whiteR;
+    uint8_t whiteG;
+    uint8_t whiteB;
+};
+
+struct OutputStage {
+    // Physical buffer attached to FastLED (corrected colours, trimmed to the last used pixel);
+    // sized for the largest profile, the active one uses physicalLeds of it
+    CRGB frame[kMaxPhysicalLeds];
+
+    // Pixels of frame the active profile uses
+    uint16_t physicalLeds = 0;
+
+    // Settings
+    uint16_t gammaX100 = OUTPUT_GAMMA_X100;
+    uint8_t brightness = OUTPUT_BRIGHTNESS;
+    OutputZone zones[OUTPUT_MAX_ZONES];
+    uint8_t zoneCount = 0;
+
+    // Derived tables
+    uint8_t lut[OUTPUT_MAX_ZONES][3][256];
+    uint8_t zoneOf[kMaxPhysicalLeds];
+    bool dirty = true;
+
+    // Logical frame last sent, kept while the governor skips unchanged frames
+    CRGB lastInput[kMaxLogicalLeds];
+    bool lastInputValid = false;
+};
+
+struct SystemState;
+
+// Take over the profile's strip length, load the zones from OUTPUT_ZONE_DEFAULTS and build the tables
+void outputStageInit(OutputStage &stage, const ProfileOps &profile);
+void outputStageSetGamma(OutputStage &stage, uint16_t gammaX100);
+void outputStageSetBrightness(OutputStage &stage, uint8_t brightness);
+// Set (or add, when zone == zoneCount) a white-balance zone; returns false when out of zones
+bool outputStageSetZone(OutputStage &stage, uint8_t zone, int start, int end, CRGB white);
+// Recompute the lookup tables and the LED-to-zone map
+void outputStageRebuild(OutputStage &stage);
+// Corrected copy of the logical leds into stage.frame through P's run table
+// (rebuilds the tables first if a setting changed). Instantiated for each
+// PROFILE_LIST entry in OutputStage.cpp; ProfileOps::apply points at these.
+template <typename P>
+void outputStageApplyFor(OutputStage &stage, const CRGB *leds);
+
+// Run the output stage on state.leds and push the frame to the strip
+void showFrame(SystemState &state);
@@ -0,0 +1,141 @@
+// Profiles.h
+// Table profiles: one firmware image for several table variants.
+//
+// A profile is a type with the segment layout (logical ranges chained from
+// per-segment LED counts), its topology run table and its effect timings as
+// compile-time constants. The effects are templates over the profile and
+// every profile in PROFILE_LIST gets its own fully specialised copy of the
+// segment update (Effects.cpp). profileSelect() picks one at boot, from a
+// stored setting or the PROFILE_STRAP_PIN strap, and SystemState::profile
+// points at its ProfileOps from then on; the frame loop makes one indirect
+// call into the specialised effects and one into the output stage, and never
+// looks at layout data.
+//
+// Adding a table: define its struct below and append it to PROFILE_LIST.
+// Static buffers are sized for the largest profile.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Config.h"
+#include "Topology.h"
+
+struct SystemState;
+struct Timers;
+struct OutputStage;
+struct CRGB;
+
+// Logical layout, packed in the same order as Config.h
+template <int Wind, int Solar, int ElectricityProduction, int HydrogenProduction, int HydrogenTransport,
+          int HydrogenStorage1, int HydrogenStorage2, int HydrogenConsumption, int ElectricityTransport,
+          int StorageTransport, int StoragePowerstation, int Fabrication>
+struct ProfileLayout {
+    static constexpr int windStart = 0;
+    static constexpr int windEnd = windStart + Wind - 1;
+    static constexpr int solarStart = windEnd + 1;
+    static constexpr int solarEnd = solarStart + Solar - 1;
+    static constexpr int electricityProductionStart = solarEnd + 1;
+    static constexpr int electricityProductionEnd = electricityProductionStart + ElectricityProduction - 1;
+    static constexpr int hydrogenProductionStart = electricityProductionEnd + 1;
+    static constexpr int hydrogenProductionEnd = hydrogenProductionStart + HydrogenProduction - 1;
+    static constexpr int hydrogenTransportStart = hydrogenProductionEnd + 1;
+    // consumption starts once the gas is 5/7 of the way along the pipe
+    static constexpr int hydrogenTransportMid = hydrogenTransportStart + HydrogenTransport * 5 / 7;
+    static constexpr int hydrogenTransportEnd = hydrogenTransportStart + HydrogenTransport - 1;
+    static constexpr int hydrogenStorage1Start = hydrogenTransportEnd + 1;
+    static constexpr int hydrogenStorage1End = hydrogenStorage1Start + HydrogenStorage1 - 1;
+    static constexpr int hydrogenStorage2Start = hydrogenStorage1End + 1;
+    static constexpr int hydrogenStorage2End = hydrogenStorage2Start + HydrogenStorage2 - 1;
+    static constexpr int hydrogenConsumptionStart = hydrogenStorage2End + 1;
+    static constexpr int hydrogenConsumptionEnd = hydrogenConsumptionStart + HydrogenConsumption - 1;
+    static constexpr int electricityTransportStart = hydrogenConsumptionEnd + 1;
+    static constexpr int electricityTransportEnd = electricityTransportStart + ElectricityTransport - 1;
+    static constexpr int storageTransportStart = electricityTransportEnd + 1;
+    static constexpr int storageTransportEnd = storageTransportStart + StorageTransport - 1;
+    static constexpr int storagePowerstationStart = storageTransportEnd + 1;
+    static constexpr int storagePowerstationEnd = storagePowerstationStart + StoragePowerstation - 1;
+    static constexpr int fabricationStart = storagePowerstationEnd + 1;
+    static constexpr int fabricationEnd = fabricationStart + Fabrication - 1;
+
+    // Info LEDs
+    static constexpr int infoStart = fabricationEnd + 1;
+    static constexpr int windInfoLed = infoStart + 0;
+    static constexpr int electrolyserInfoLed = infoStart + 1;
+    static constexpr int hydrogenProductionInfoLed = infoStart + 2;
+    static constexpr int hydrogenStorageInfoLed = infoStart + 3;
+    static constexpr int hydrogenConsumptionInfoLed = infoStart + 4;
+    static constexpr int electricityTransportInfoLed = infoStart + 5;
+    static constexpr int streetLed = infoStart + 6;
+
+    static constexpr int logicalLeds = infoStart + INFO_LED_COUNT;
+};
+
+// The original table: the Config.h layout, TOPOLOGY_RUNS and timings
+struct ProfileStandard
+    : ProfileLayout<WIND_LED_COUNT, SOLAR_LED_COUNT, ELECTRICITY_PRODUCTION_LED_COUNT, HYDROGEN_PRODUCTION_LED_COUNT,
+                    HYDROGEN_TRANSPORT_LED_COUNT, HYDROGEN_STORAGE1_LED_COUNT, HYDROGEN_STORAGE2_LED_COUNT,
+                    HYDROGEN_CONSUMPTION_LED_COUNT, ELECTRICITY_TRANSPORT_LED_COUNT, STORAGE_TRANSPORT_LED_COUNT,
+                    STORAGE_POWERSTATION_LED_COUNT, FABRICATION_LED_COUNT> {
+    static const char *name() { return "standard"; }
+    static constexpr int stripLeds = NUM_LEDS;
+    static constexpr uint32_t ledDelay = LED_DELAY;
+    static constexpr uint32_t ledDelay2 = LED_DELAY2;
+    static constexpr uint32_t hydrogenProductionDelayMs = HYDROGEN_PRODUCTION_DELAY_MS;
+    static constexpr uint32_t hydrogenStorageDelayMs = HYDROGEN_STORAGE_DELAY_MS;
+    // Config.h sets where consumption starts instead of the 5/7 default
+    static constexpr int hydrogenTransportMid = HYDROGEN_TRANSPORT_LED_MID;
+    static constexpr TopologyRun runs[] = TOPOLOGY_RUNS;
+};
+
+// Compact table: a 60-LED strip with every pixel in use and shorter segments.
+// The chasers step more slowly so a pass still takes about as long.
+struct ProfileCompact : ProfileLayout<4, 4, 4, 4, 5, 2, 4, 4, 6, 4, 4, 8> {
+    static const char *name() { return "compact"; }
+    static constexpr int stripLeds = 60;
+    static constexpr uint32_t ledDelay = 300;
+    static constexpr uint32_t ledDelay2 = 150;
+    static constexpr uint32_t hydrogenProductionDelayMs = HYDROGEN_PRODUCTION_DELAY_MS;
+    static constexpr uint32_t hydrogenStorageDelayMs = HYDROGEN_STORAGE_DELAY_MS;
+    static constexpr TopologyRun runs[] = { { 0, 0, logicalLeds } };
+};
+
+// Every profile in the image, in selection order (index 0 is the default)
+#define PROFILE_LIST(X) \
+    X(ProfileStandard)  \
+    X(ProfileCompact)
+
+// What the runtime needs from the profile picked at boot
+struct ProfileOps {
+    const char *name;
+    void (*update)(SystemState &state, Timers &timers);
+    void (*reset)(SystemState &state, Timers &timers, uint32_t now);
+    void (*apply)(OutputStage &stage, const CRGB *leds);
+    const TopologyRun *runs;
+    uint8_t runCount;
+    uint16_t logicalLeds;
+    uint16_t physicalLeds;
+};
+
+extern const ProfileOps kProfiles[];
+extern const uint8_t kProfileCount;
+
+// Largest logical / physical buffer over all profiles (static buffer sizes)
+template <size_t N>
+constexpr int profileMax(const int (&values)[N], size_t i = 0) {
+    return i >= N ? 0 : (values[i] > profileMax(values, i + 1) ? values[i] : profileMax(values, i + 1));
+}
+#define PROFILE_LOGICAL_LEDS(P) P::logicalLeds,
+#define PROFILE_PHYSICAL_LEDS(P) topologyPhysicalLeds(P::runs),
+static constexpr int kProfileLogicalLeds[] = { PROFILE_LIST(PROFILE_LOGICAL_LEDS) };
+static constexpr int kProfilePhysicalLeds[] = { PROFILE_LIST(PROFILE_PHYSICAL_LEDS) };
+static constexpr int kMaxLogicalLeds = profileMax(kProfileLogicalLeds);
+static constexpr int kMaxPhysicalLeds = profileMax(kProfilePhysicalLeds);
+
+// Pick the boot profile: the stored setting if there is a valid one, else the
+// strap (PROFILE_STRAP_PIN pulled LOW selects index 1)
+const ProfileOps &profileSelect();
+// Store the profile index used from the next boot on; 0xFF clears the setting
+bool profileStore(uint8_t index);
+// Stored index, or -1 when none is stored
+int profileStored();
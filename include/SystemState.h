@@ -7,35 +7,39 @@
 // bring in FastLED types and configuration macros
 #include <FastLED.h>
 #include "Config.h"
+#include "EffectPool.h"
+#include "Coroutine.h"
+#include "fadeLeds.h"
+#include "fireEffect.h"
+#include "gasFlow.h"
+#include "model/HydrogenModel.h"
+#include "OutputStage.h"
+#include "Profiles.h"
+#include "FrameGovernor.h"
+#include "EffectLook.h"
+#include "Trace.h"
+#if FRAME_MIRROR
+#include "FrameMirror.h"
+#endif
+#if IDLE_CLIP
+#include "ClipPlayer.h"
+#endif
 
 struct Timers {
     uint32_t previousButtonCheckMillis = 0;
     uint32_t buttonDisableStartTime = 0;
     uint32_t generalTimerStartTime = 0;
-    uint32_t previousMillisWind = 0;
-    uint32_t previousMillisSolar = 0;
-    uint32_t previousMillisElectricityProduction = 0;
-    uint32_t previousMillisElectrolyser = 0;
-    uint32_t previousMillisHydrogenTransport = 0;
-    uint32_t previousMillisHydrogenProduction = 0;
-    uint32_t previousMillisHydrogenStorage = 0;
-    uint32_t previousMillisHydrogenStorage2 = 0;
-    uint32_t previousMillisH2Consumption = 0;
-    uint32_t hydrogenStorageFullStartTime = 0;
-    uint32_t previousMillisElectricityTransport = 0;
-    uint32_t previousMillisStorageTransport = 0;
-    uint32_t previousMillisStoragePowerstation = 0;
-    uint32_t hydrogenStorageFullTimer = 0;
+    uint32_t lastPressTime = 0;           // button debounce
 };
 
-// forward-declare fadeLeds (global scope) so we can keep a pointer here
-class fadeLeds;
-
 struct SystemState {
+    // Table profile picked at boot (layout, topology, specialised segment update)
+    const ProfileOps *profile = &kProfiles[0];
+
     // Button / timers / flags
     bool buttonDisabled = false;
     bool generalTimerActive = false;
-    bool storageTimerStarted = false;
+    bool storageDraining = false;
 
     // Mode flags
     bool windOn = false;
@@ -60,30 +64,67 @@ struct SystemState {
     int solarSegment = 0;
     int electricityProductionSegment = 0;
     int hydrogenTransportSegment = 0;
-    int hydrogenProductionSegment = 0;
-    int hydrogenStorageSegment1 = 0;
-    int hydrogenStorageSegment2 = 0;
     int h2ConsumptionSegment = 0;
     int electricityTransportSegment = 0;
     int storageTransportSegment = 0;
     int storagePowerstationSegment = 0;
 
-    // First-run flags
-    bool firstRunWind = true;
-    bool firstRunSolar = true;
-    bool firstRunElectricityProduction = true;
+    // First-run flag for the hydrogen production fade
     bool firstRunHydrogenProduction = true;
-    bool firstRunHydrogenTransport = true;
-    bool firstRunHydrogenStorage = true;
-    bool firstRunHydrogenStorage2 = true;
-    bool firstRunH2Consumption = true;
-    bool firstRunElectricityTransport = true;
-    bool firstRunStorageTransport = true;
-    bool firstRunStoragePowerstation = true;
-    // LED framebuffer owned by the runtime state
-    CRGB leds[NUM_LEDS];
-
-    // fadeEffect instance pointer (allocated during setup)
-    fadeLeds *fadeEffect = nullptr;
+
+    // Sequential effect bodies (resume point + wake time, see Coroutine.h)
+    Coroutine windTask;
+    Coroutine electricityProductionTask;
+    Coroutine electrolyserTask;
+    Coroutine storageDrainTask;
+    Coroutine storageTransportTask;
+    Coroutine electricityTransportTask;
+
+    // Fixed-step hydrogen system model (flow rates, storage mass)
+    HydrogenModel model;
+
+    // Logical LED framebuffer owned by the runtime state (see Topology.h);
+    // sized for the largest profile, the active one uses profile->logicalLeds
+    CRGB leds[kMaxLogicalLeds];
+#if LED_GUARD_PIXELS
+    CRGB ledGuard[LED_GUARD_PIXELS];
+#endif
+
+    // Gamma / white balance / brightness stage; owns the buffer FastLED sends
+    OutputStage output;
+
+    // Frame cost budget and current quality level
+    FrameGovernor governor;
+
+    // Colours, chaser delays and fire shape read by the effects
+    EffectLook look;
+
+#if FRAME_MIRROR
+    // Live frame mirror over Serial
+    FrameMirror mirror;
+#endif
+
+#if IDLE_CLIP
+    // Attract loop streamed from flash while idle
+    ClipPlayer idleClip;
+#endif
+
+#if TRACE_EVENTS
+    // Stage changes, timer starts and show() spans, dumped with 't' over Serial
+    Trace trace;
+#endif
+
+    // Statically allocated effect instances (no heap use after boot)
+    EffectPool<fadeLeds, MAX_FADE_EFFECTS> fades;
+    EffectPool<fireLeds, MAX_FIRE_EFFECTS> fires;
+    EffectPool<gasFlow, MAX_GAS_FLOW_EFFECTS> flows;
+
+    // Handles to the pooled instances used by the flow (acquired during setup)
+    EffectHandle hydrogenProductionFade;
+    EffectHandle fabricationFire;
+    EffectHandle hydrogenTransportFlow;
+    EffectHandle hydrogenStorageFlow1;
+    EffectHandle hydrogenStorageFlow2;
+    EffectHandle h2ConsumptionFlow;
 };
 // End of SystemState.h
\ No newline at end of file
@@ -0,0 +1,75 @@
+// Topology.h
+// Logical-to-physical LED map.
+//
+// Effects draw into a compact logical buffer (the profile's logicalLeds
+// pixels, see Profiles.h). Each profile's run table places its logical
+// segments on the physical strip; the output stage applies the map while it
+// copies pixels into the frame FastLED sends. Strip pixels no run covers stay
+// black, and everything after the last used pixel is not transmitted at all.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct TopologyRun {
+    uint16_t logicalStart;
+    uint16_t physicalStart;
+    uint16_t length;
+};
+
+// ---- Compile time (static buffer sizes and checks)
+
+// End of one run clipped to limit, 0 if it starts at or above limit
+constexpr int topologyEndBelow(const TopologyRun &run, int limit) {
+    return run.physicalStart >= limit ? 0
+         : run.physicalStart + run.length < limit ? run.physicalStart + run.length : limit;
+}
+
+constexpr int topologyMax(int a, int b) {
+    return a > b ? a : b;
+}
+
+// One past the highest physical pixel used by runs [i, N) that start below limit.
+// The tail is evaluated once per run, so this stays linear in N.
+template <size_t N>
+constexpr int topologyUsedBelow(const TopologyRun (&runs)[N], int limit, size_t i = 0) {
+    return i >= N ? 0 : topologyMax(topologyEndBelow(runs[i], limit), topologyUsedBelow(runs, limit, i + 1));
+}
+
+// Physical pixels that have to be clocked out (trailing unused pixels trimmed)
+template <size_t N>
+constexpr int topologyPhysicalLeds(const TopologyRun (&runs)[N]) {
+    return topologyUsedBelow(runs, 0x7FFF);
+}
+
+// True when every run stays inside a logical buffer of logicalLeds pixels
+template <size_t N>
+constexpr bool topologyLogicalInRange(const TopologyRun (&runs)[N], int logicalLeds, size_t i = 0) {
+    return i >= N ? true
+         : runs[i].logicalStart + runs[i].length <= logicalLeds && topologyLogicalInRange(runs, logicalLeds, i + 1);
+}
+
+// ---- Run time (for the table picked at boot)
+
+inline int topologyUsedBelow(const TopologyRun *runs, uint8_t count, int limit) {
+    int used = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+        int end = runs[i].physicalStart + runs[i].length;
+        if (runs[i].physicalStart >= limit) continue;
+        if (end > limit) end = limit;
+        if (end > used) used = end;
+    }
+    return used;
+}
+
+// Physical pixel showing logical pixel `logical` (later runs win), or -1 if unmapped
+inline int topologyPhysicalOf(const TopologyRun *runs, uint8_t count, int logical) {
+    int physical = -1;
+    for (uint8_t i = 0; i < count; ++i) {
+        if (logical >= runs[i].logicalStart && logical < runs[i].logicalStart + runs[i].length) {
+            physical = runs[i].physicalStart + (logical - runs[i].logicalStart);
+        }
+    }
+    return physical;
+}
@@ -0,0 +1,87 @@
+// Trace.h
+// Low-overhead event trace for working out the ordering of flag changes on
+// site: ring buffers of stage on/off changes, timer starts and show() spans
+// with micros() timestamps, dumped as Chrome trace JSON for Perfetto
+// (ui.perfetto.dev) or chrome://tracing.
+//
+// Stage and timer events are not recorded where the flags are assigned:
+// TRACE_OBSERVE compares the stage flags and the coroutine timers in
+// SystemState with what it saw last time, once after the button check, the
+// model step and every registered effect (EffectRegistry.h). Each change is
+// therefore attributed to the effect that made it. Stage changes go to a ring
+// of their own, so the much more frequent timer starts and spans can't push
+// them out.
+//
+// With TRACE_EVENTS at 0 (Config.h) the macros expand to nothing and
+// SystemState has no trace member.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Config.h"
+
+// TRACE_EVENTS bits
+#define TRACE_STAGES 1
+#define TRACE_TIMERS 2
+#define TRACE_SHOW_SPANS 4
+
+#if TRACE_EVENTS
+
+struct SystemState;
+struct Timers;
+
+static const uint8_t TRACE_STAGE_ON = 0;
+static const uint8_t TRACE_STAGE_OFF = 1;
+static const uint8_t TRACE_TIMER_START = 2;
+static const uint8_t TRACE_SPAN = 3;
+
+struct TraceEvent {
+    uint32_t us;            // micros() of the change, or of the span start
+    uint32_t arg;           // timer length in ms, span length in us
+    const char *source;     // effect that made the change, or the span name
+    uint8_t kind;
+    uint8_t id;             // stage flag or timer index (Trace.cpp)
+};
+
+template <uint16_t N>
+struct TraceRing {
+    TraceEvent events[N];
+    uint16_t next = 0;           // slot the next event goes to
+    uint16_t count = 0;
+    uint32_t overwritten = 0;    // events lost to the ring wrapping
+};
+
+struct Trace {
+    TraceRing<TRACE_STAGE_CAPACITY> stageEvents;
+    TraceRing<TRACE_CAPACITY> events;    // timer starts and show() spans
+
+    // What TRACE_OBSERVE saw last time
+    uint32_t stages = 0;
+    uint32_t timerWake[8] = {};
+    uint8_t timersArmed = 0;
+};
+
+// Record the stage flags and timers that changed since the last call
+void traceObserve(Trace &trace, const SystemState &state, const Timers &timers, const char *source);
+// Record a span that started at startUs and ends now
+void traceSpan(Trace &trace, const char *name, uint32_t startUs);
+
+// Chrome trace JSON, written in pieces of at most one line
+typedef void (*TraceWriter)(void *context, const char *text);
+void traceWriteJson(const Trace &trace, TraceWriter write, void *context);
+// traceWriteJson() over Serial
+void traceDump(const Trace &trace);
+
+#define TRACE_OBSERVE(state, timers, source) traceObserve((state).trace, (state), (timers), (source))
+#else
+#define TRACE_OBSERVE(state, timers, source) ((void)0)
+#endif
+
+#if TRACE_EVENTS & TRACE_SHOW_SPANS
+#define TRACE_SPAN_BEGIN(var) const uint32_t var = micros()
+#define TRACE_SPAN_END(state, var, name) traceSpan((state).trace, (name), (var))
+#else
+#define TRACE_SPAN_BEGIN(var) ((void)0)
+#define TRACE_SPAN_END(state, var, name) ((void)0)
+#endif
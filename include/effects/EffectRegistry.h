@@ -0,0 +1,41 @@
+// EffectRegistry.h
+// Compile-time list of effect types.
+//
+// An effect is a type with three static members:
+//     static void update(SystemState &state, Timers &timers);
+//     static void reset(SystemState &state, Timers &timers, uint32_t now);
+//     static const char *name();   // shown as the cause of changes in the trace (Trace.h)
+// EffectList<A, B, C>::update() expands at compile time into A::update();
+// B::update(); C::update(); in list order, so there is no table of function
+// pointers and the compiler can inline each effect into the sequence.
+
+#pragma once
+
+#include <stdint.h>
+#include "../SystemState.h"
+
+template <typename... Effects>
+struct EffectList;
+
+template <>
+struct EffectList<> {
+    static inline void update(SystemState &, Timers &) {}
+    static inline void reset(SystemState &, Timers &, uint32_t) {}
+    static constexpr unsigned size() { return 0; }
+};
+
+template <typename First, typename... Rest>
+struct EffectList<First, Rest...> {
+    static inline void update(SystemState &state, Timers &timers) {
+        First::update(state, timers);
+        TRACE_OBSERVE(state, timers, First::name());
+        EffectList<Rest...>::update(state, timers);
+    }
+
+    static inline void reset(SystemState &state, Timers &timers, uint32_t now) {
+        First::reset(state, timers, now);
+        EffectList<Rest...>::reset(state, timers, now);
+    }
+
+    static constexpr unsigned size() { return 1 + EffectList<Rest...>::size(); }
+};
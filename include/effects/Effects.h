@@ -2,18 +2,108 @@
 #define EFFECTS_H
 
 #include "../SystemState.h"
+#include "EffectRegistry.h"
+#include "../Profiles.h"
 
-// Effects now accept a reference to the centralized SystemState and Timers
-void updateWindEffect(SystemState &state, Timers &timers);
-void updateElectricityProductionEffect(SystemState &state, Timers &timers);
-void updateElectrolyserEffect(SystemState &state, Timers &timers);
-void updateHydrogenProductionEffect(SystemState &state, Timers &timers);
-void updateHydrogenTransportEffect(SystemState &state, Timers &timers);
-void updateHydrogenStorageEffect(SystemState &state, Timers &timers);
-void updateH2ConsumptionEffect(SystemState &state, Timers &timers);
-void updateFabricationEffect(SystemState &state, Timers &timers);
-void updateStorageTransportEffect(SystemState &state, Timers &timers);
-void updateElectricityEffect(SystemState &state, Timers &timers);
-void updateInformationLEDs(SystemState &state, Timers &timers);
+// Each effect is a type with static update()/reset() that take the
+// centralized SystemState and Timers. reset() puts the effect's own flags,
+// cursors and timers back to their idle values.
+// Effects are templates over the table profile P (Profiles.h), which supplies
+// the segment ranges and step timings as compile-time constants.
+template <typename P>
+struct WindEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "wind"; }
+};
+template <typename P>
+struct ElectricityProductionEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "electricity production"; }
+};
+template <typename P>
+struct ElectrolyserEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "electrolyser"; }
+};
+template <typename P>
+struct HydrogenProductionEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "hydrogen production"; }
+};
+template <typename P>
+struct HydrogenTransportEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "hydrogen transport"; }
+};
+template <typename P>
+struct HydrogenStorageEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "hydrogen storage"; }
+};
+template <typename P>
+struct H2ConsumptionEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "h2 consumption"; }
+};
+template <typename P>
+struct FabricationEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "fabrication"; }
+};
+template <typename P>
+struct ElectricityEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "electricity transport"; }
+};
+template <typename P>
+struct StorageTransportEffect {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "storage transport"; }
+};
+template <typename P>
+struct InformationLEDs {
+    static void update(SystemState &state, Timers &timers);
+    static void reset(SystemState &state, Timers &timers, uint32_t now);
+    static const char *name() { return "information LEDs"; }
+};
+
+// The effect registry: update order of the segments. Add new effects here.
+template <typename P>
+using SegmentEffects = EffectList<
+    WindEffect<P>,
+    ElectricityProductionEffect<P>,
+    ElectrolyserEffect<P>,
+    HydrogenProductionEffect<P>,
+    HydrogenTransportEffect<P>,
+    HydrogenStorageEffect<P>,
+    H2ConsumptionEffect<P>,
+    FabricationEffect<P>,
+    ElectricityEffect<P>,
+    StorageTransportEffect<P>,
+    // the small information LEDs (status indicators) go last
+    InformationLEDs<P>
+>;
+
+// The registry expanded for one profile (instantiated for each PROFILE_LIST
+// entry in Effects.cpp; ProfileOps points at these)
+template <typename P>
+void updateSegmentsFor(SystemState &state, Timers &timers);
+template <typename P>
+void resetSegmentsFor(SystemState &state, Timers &timers, uint32_t now);
+
+// Run every registered effect once, in registry order, for the active profile
+void updateSegments(SystemState &state, Timers &timers);
+// Reset every registered effect to idle
+void resetSegments(SystemState &state, Timers &timers, uint32_t now);
 
 #endif
@@ -0,0 +1,47 @@
+// HydrogenModel.h
+// Small quantitative model of the hydrogen system that drives the visuals.
+//
+// Quantities are Q16.16 fixed point and the model advances in fixed
+// MODEL_STEP_MS steps from an accumulator, independent of how often loop()
+// runs. Effects read flow speed and fill level from here instead of deriving
+// stage changes from chaser cursor positions.
+
+#pragma once
+
+#include <stdint.h>
+
+// Q16.16 fixed point
+typedef int32_t q16_t;
+#define Q16_ONE ((q16_t)65536)
+#define Q16(x) ((q16_t)((x) * 65536.0 + 0.5))
+
+inline q16_t q16Mul(q16_t a, q16_t b) { return (q16_t)(((int64_t)a * b) >> 16); }
+inline q16_t q16Div(q16_t a, q16_t b) { return b ? (q16_t)(((int64_t)a << 16) / b) : 0; }
+
+struct HydrogenModel {
+    q16_t windPowerKw = 0;         // turbine output
+    q16_t electrolyserKw = 0;      // power taken by the electrolyser
+    q16_t productionGps = 0;       // H2 produced (g/s, demo time)
+    q16_t consumptionGps = 0;      // H2 drawn by the factory
+    q16_t storageInflowGps = 0;    // production surplus going into storage
+    q16_t storageOutflowGps = 0;   // H2 leaving storage for the powerstation
+    q16_t storageMassG = 0;        // H2 in storage
+
+    uint32_t previousMillis = 0;
+    uint32_t accumulatorMs = 0;
+};
+
+struct SystemState;
+
+// Clear all quantities and restart the step clock at now
+void hydrogenModelReset(HydrogenModel &model, uint32_t now);
+// Run as many fixed steps as have elapsed since the last call, using the stage flags in state
+void hydrogenModelUpdate(SystemState &state, uint32_t now);
+
+// Gas packet speed (1/256 LED per gasFlow step) for a mass flow; 0 when nothing flows
+uint8_t hydrogenModelFlowSpeed(q16_t massFlowGps);
+// Packet emission density (0..255) for a mass flow
+uint8_t hydrogenModelFlowDensity(q16_t massFlowGps);
+// Number of LEDs of a storage segment that show stored gas
+int hydrogenModelStorageFill(const HydrogenModel &model, int length);
+bool hydrogenModelStorageFull(const HydrogenModel &model);
@@ -1,12 +1,17 @@
 #include "fireEffect.h"
 
-// Fire effect function
-void fireEffect(CRGB* leds, int startLed, int endLed) {
-    static uint8_t heat[256];  // Array to store heat values for each LED
-    static uint32_t previousMillis = 0;  // Stores the last update time
-    const uint8_t cooling = 55;         // Default cooling value
-    const uint8_t sparking = 120;       // Default sparking value
-    const uint32_t wait = 50;           // Default wait time in milliseconds
+fireLeds::fireLeds(uint8_t cooling, uint8_t sparking, uint32_t wait)
+    : previousMillis(0), cooling(cooling), sparking(sparking), wait(wait) {
+    memset(heat, 0, sizeof(heat));
+}
+
+void fireLeds::update(CRGB* leds, int startLed, int endLed) {
+    // Clamp the segment to the heat map size
+    if (endLed - startLed + 1 > FIRE_MAX_LEDS) {
+        endLed = startLed + FIRE_MAX_LEDS - 1;
+    }
+    const int count = endLed - startLed + 1;
+    if (count <= 0) return;
 
     uint32_t currentMillis = millis();
 
@@ -15,23 +20,23 @@ void fireEffect(CRGB* leds, int startLed, int endLed) {
         previousMillis = currentMillis;  // Update the last update time
 
         // Step 1: Cool down every cell a little
-        for (int i = startLed; i <= endLed; i++) {
-            heat[i] = qsub8(heat[i], random8(0, ((cooling * 10) / (endLed - startLed + 1)) + 2));
+        for (int i = 0; i < count; i++) {
+            heat[i] = qsub8(heat[i], random8(0, ((cooling * 10) / count) + 2));
         }
 
         // Step 2: Heat from each cell drifts 'up' and diffuses a little
-        for (int i = endLed; i >= startLed + 2; i--) {
+        for (int i = count - 1; i >= 2; i--) {
             heat[i] = (heat[i - 1] + heat[i - 2] + heat[i - 2]) / 3;
         }
 
         // Step 3: Randomly ignite new sparks near the bottom
         if (random8() < sparking) {
-            int y = random8(startLed, startLed + 7);
+            int y = random8(0, count < 7 ? count : 7);
             heat[y] = qadd8(heat[y], random8(160, 255));
         }
 
         // Step 4: Map from heat cells to LED colors with more red
-        for (int i = startLed; i <= endLed; i++) {
+        for (int i = 0; i < count; i++) {
             CRGB color = HeatColor(heat[i]);
 
             // Adjust the color to emphasize red tones
@@ -45,7 +50,7 @@ void fireEffect(CRGB* leds, int startLed, int endLed) {
                 color.g = scale8(color.g, 120);  // Scale down green more aggressively
             }
 
-            leds[i] = color;
+            leds[startLed + i] = color;
         }
     }
-}
\ No newline at end of file
+}
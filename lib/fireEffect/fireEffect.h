@@ -3,7 +3,45 @@
 
 #include <FastLED.h>
 
-// Function to apply a fire effect to a segment of LEDs
-void fireEffect(CRGB* leds, int startLed, int endLed);
+// Longest segment a single fire instance can animate
+#ifndef FIRE_MAX_LEDS
+#define FIRE_MAX_LEDS 32
+#endif
 
-#endif // FIRE_EFFECT_H
\ No newline at end of file
+// Default time between fire steps
+#ifndef FIRE_WAIT_MS
+#define FIRE_WAIT_MS 50
+#endif
+
+// Default heat model: cooling per step and spark chance 0..255
+#ifndef FIRE_COOLING
+#define FIRE_COOLING 55
+#endif
+#ifndef FIRE_SPARKING
+#define FIRE_SPARKING 120
+#endif
+
+// Fire effect with its own heat map and timer, so several segments can burn
+// independently. Heat cells are indexed relative to startLed.
+class fireLeds {
+public:
+    fireLeds(uint8_t cooling = FIRE_COOLING, uint8_t sparking = FIRE_SPARKING, uint32_t wait = FIRE_WAIT_MS);
+
+    void update(CRGB* leds, int startLed, int endLed);
+    // Time between fire steps; a longer wait is cheaper and flickers slower
+    void setWait(uint32_t ms) { wait = ms; }
+    // Heat model: how fast cells cool and how often new sparks ignite
+    void setShape(uint8_t newCooling, uint8_t newSparking) {
+        cooling = newCooling;
+        sparking = newSparking;
+    }
+
+private:
+    uint8_t heat[FIRE_MAX_LEDS];
+    uint32_t previousMillis;
+    uint8_t cooling;
+    uint8_t sparking;
+    uint32_t wait;
+};
+
+#endif // FIRE_EFFECT_H
@@ -0,0 +1,163 @@
+#include "gasFlow.h"
+
+gasFlow::gasFlow(uint32_t stepMs)
+    : particles(0), settledCount(0), exited(0), segmentLength(0), drainAccumulator(0), fillDriven(false), stepMs(stepMs), previousMillis(0), started(false),
+      speed(32), density(96), emitting(false), outletOpen(true), smooth(true) {}
+
+void gasFlow::reset() {
+    particles = 0;
+    settledCount = 0;
+    exited = 0;
+    drainAccumulator = 0;
+    fillDriven = false;
+    started = false;
+}
+
+void gasFlow::setFlow(uint8_t newSpeed, uint8_t newDensity) {
+    speed = newSpeed ? newSpeed : 1;
+    density = newDensity;
+}
+
+void gasFlow::removeAt(uint16_t i) {
+    // order doesn't matter, so move the last particle into the hole
+    --particles;
+    position[i] = position[particles];
+    velocity[i] = velocity[particles];
+    brightness[i] = brightness[particles];
+}
+
+void gasFlow::step(int length) {
+    // 32-bit so a fast packet near the end can't wrap back to the inlet
+    const uint32_t outlet = (uint32_t)length << 8;
+
+    // Move packets; the settle line moves back as the segment fills
+    for (uint16_t i = 0; i < particles;) {
+        const uint32_t pos = (uint32_t)position[i] + velocity[i];
+        if (outletOpen) {
+            if (pos >= outlet) {
+                removeAt(i);
+                ++exited;
+                continue;
+            }
+        } else {
+            if (settledCount >= length) {
+                // Segment is full, nothing more fits
+                removeAt(i);
+                continue;
+            }
+            const uint32_t settleLine = (uint32_t)(length - 1 - settledCount) << 8;
+            if (pos >= settleLine) {
+                removeAt(i);
+                if (!fillDriven) ++settledCount;
+                continue;
+            }
+        }
+        position[i] = (uint16_t)pos;
+        ++i;
+    }
+
+    // Draining: settled gas leaves through the outlet at the flow speed
+    if (outletOpen && settledCount > 0 && !fillDriven) {
+        drainAccumulator += speed;
+        if (drainAccumulator >= 256) {
+            drainAccumulator -= 256;
+            --settledCount;
+            ++exited;
+        }
+    }
+
+    // Emit a new packet at the inlet
+    if (emitting && particles < GAS_FLOW_MAX_PARTICLES && random8() < density) {
+        uint16_t v = ((uint16_t)speed * (192 + random8(128))) >> 8;  // +/- 25% jitter
+        position[particles] = 0;
+        velocity[particles] = v ? (v > 255 ? 255 : v) : 1;
+        brightness[particles] = 160 + random8(96);
+        ++particles;
+    }
+}
+
+uint16_t gasFlow::update(int length) {
+    uint32_t currentMillis = millis();
+    if (!started) {
+        started = true;
+        previousMillis = currentMillis;
+        return 0;
+    }
+    if (length <= 0) return 0;
+    if (length > GAS_FLOW_MAX_LENGTH) length = GAS_FLOW_MAX_LENGTH;
+    segmentLength = length;
+
+    uint32_t steps = (currentMillis - previousMillis) / stepMs;
+    if (steps == 0) return 0;
+    // Catch up at most a few steps after a long frame instead of bursting
+    if (steps > 8) {
+        steps = 8;
+        previousMillis = currentMillis;
+    } else {
+        previousMillis += steps * stepMs;
+    }
+
+    exited = 0;
+    while (steps--) step(length);
+    return exited;
+}
+
+void gasFlow::render(CRGB* leds, int start, int end, CRGB color, CRGB background) const {
+    const int length = end - start + 1;
+    if (length <= 0) return;
+
+    fill_solid(leds + start, length, background);
+
+    // Settled gas packs against the end of the segment
+    int settledFrom = length - (settledCount > length ? length : settledCount);
+    for (int i = settledFrom; i < length; i++) {
+        leds[start + i] = color;
+    }
+
+    // Cheap variant: each packet lights only its nearest LED
+    if (!smooth) {
+        for (uint16_t i = 0; i < particles; i++) {
+            int idx = (position[i] + 128) >> 8;
+            if (idx < length) {
+                CRGB& px = leds[start + idx];
+                px.r = qadd8(px.r, scale8(color.r, brightness[i]));
+                px.g = qadd8(px.g, scale8(color.g, brightness[i]));
+                px.b = qadd8(px.b, scale8(color.b, brightness[i]));
+            }
+        }
+        return;
+    }
+
+    // Moving packets are spread over the two nearest LEDs
+    for (uint16_t i = 0; i < particles; i++) {
+        int idx = position[i] >> 8;
+        uint8_t frac = position[i] & 0xFF;
+        uint8_t b = brightness[i];
+        uint8_t near = scale8(b, 255 - frac);
+        uint8_t far = scale8(b, frac);
+
+        if (idx < length) {
+            CRGB& px = leds[start + idx];
+            px.r = qadd8(px.r, scale8(color.r, near));
+            px.g = qadd8(px.g, scale8(color.g, near));
+            px.b = qadd8(px.b, scale8(color.b, near));
+        }
+        if (idx + 1 < length) {
+            CRGB& px = leds[start + idx + 1];
+            px.r = qadd8(px.r, scale8(color.r, far));
+            px.g = qadd8(px.g, scale8(color.g, far));
+            px.b = qadd8(px.b, scale8(color.b, far));
+        }
+    }
+}
+
+int gasFlow::front() const {
+    // Settled gas always sits at the far end
+    if (settledCount > 0) return segmentLength - 1;
+    int best = -1;
+    for (uint16_t i = 0; i < particles; i++) {
+        int idx = position[i] >> 8;
+        if (idx > best) best = idx;
+    }
+    return best;
+}
@@ -0,0 +1,93 @@
+#ifndef GASFLOW_H
+#define GASFLOW_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Particle capacity of one gasFlow instance
+#ifndef GAS_FLOW_MAX_PARTICLES
+#define GAS_FLOW_MAX_PARTICLES 96
+#endif
+
+// Longest segment one instance can animate: positions are 8.8 fixed point in a uint16_t
+#ifndef GAS_FLOW_MAX_LENGTH
+#define GAS_FLOW_MAX_LENGTH 255
+#endif
+static_assert(GAS_FLOW_MAX_LENGTH <= 255, "gasFlow positions are 8.8 fixed point in a uint16_t");
+
+// Fixed simulation step in milliseconds
+#ifndef GAS_FLOW_STEP_MS
+#define GAS_FLOW_STEP_MS 20
+#endif
+
+// Particle-system renderer for gas flowing through a pipe segment.
+//
+// Each particle is a small gas "packet" with its own velocity and brightness.
+// Particles are kept in fixed-size structure-of-arrays storage (position in
+// 8.8 fixed-point LEDs, velocity in 1/256 LED per step, brightness), so the
+// update and rasterise loops never allocate and walk contiguous arrays.
+//
+// With the outlet open particles leave at the end of the segment; with it
+// closed they settle against the end and the segment fills up like a tank.
+// Opening the outlet of a filled segment drains it again.
+class gasFlow {
+public:
+    gasFlow(uint32_t stepMs = GAS_FLOW_STEP_MS);
+
+    // Remove all particles (moving and settled)
+    void reset();
+
+    // speed: base velocity in 1/256 LED per step; density: chance (0..255) to emit a packet per step
+    void setFlow(uint8_t speed, uint8_t density);
+    void setEmitting(bool on) { emitting = on; }
+    void setOutletOpen(bool open) { outletOpen = open; }
+    // Hand the fill level to the caller (e.g. a model); call it before update().
+    // Settled gas is then what was last set here: packets reaching it are
+    // absorbed and an open outlet no longer drains it. reset() hands the fill
+    // level back to the simulation.
+    void setFillLevel(uint16_t leds) {
+        settledCount = leds;
+        fillDriven = true;
+    }
+    // Anti-aliased packets (default) or the cheaper nearest-LED drawing
+    void setSmooth(bool on) { smooth = on; }
+
+    // Advance the simulation to now (length is clamped to GAS_FLOW_MAX_LENGTH);
+    // returns the number of packets that left through the outlet
+    uint16_t update(int length);
+
+    // Draw the segment: background, settled gas, then moving packets (additive, anti-aliased)
+    void render(CRGB* leds, int start, int end, CRGB color, CRGB background) const;
+
+    // Relative index of the leading gas (moving or settled), -1 when the segment is empty
+    int front() const;
+    uint16_t count() const { return particles; }
+    uint16_t settled() const { return settledCount; }
+    bool empty() const { return particles == 0 && settledCount == 0; }
+    bool full(int length) const { return settledCount >= length; }
+
+private:
+    void step(int length);
+    void removeAt(uint16_t i);
+
+    uint16_t position[GAS_FLOW_MAX_PARTICLES];
+    uint8_t velocity[GAS_FLOW_MAX_PARTICLES];
+    uint8_t brightness[GAS_FLOW_MAX_PARTICLES];
+    uint16_t particles;
+    uint16_t settledCount;
+    uint16_t exited;
+    int segmentLength;
+    uint16_t drainAccumulator;
+    bool fillDriven;
+
+    uint32_t stepMs;
+    uint32_t previousMillis;
+    bool started;
+    uint8_t speed;
+    uint8_t density;
+    bool emitting;
+    bool outletOpen;
+    bool smooth;
+};
+
+#endif // GASFLOW_H
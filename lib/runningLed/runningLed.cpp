@@ -1,5 +1,47 @@
 #include "runningLed.h"
 
+int chaserStep(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR, int currentLed, bool dimPrevious) {
+    // Dim the previous LED
+    if (dimPrevious) {
+        if (currentLed > startLed) {
+            leds[currentLed - 1] = DIMCOLOR;  // Dim the previous LED
+        } else if (currentLed == startLed) {
+            leds[endLed] = DIMCOLOR;  // Dim the last LED when looping back
+        }
+    }
+
+    // Set the current LED to the active color
+    leds[currentLed] = COLOR;
+
+    // Move to the next LED
+    currentLed++;
+    if (currentLed > endLed) {
+        currentLed = startLed;  // Loop back to the start LED
+    }
+    return currentLed;
+}
+
+int reverseChaserStep(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR, int currentLed, bool dimPrevious) {
+    // Dim the previous LED
+    if (dimPrevious) {
+        if (currentLed < endLed) {
+            leds[currentLed + 1] = DIMCOLOR;  // Dim the next LED
+        } else if (currentLed == endLed) {
+            leds[startLed] = DIMCOLOR;  // Dim the first LED when looping back
+        }
+    }
+
+    // Set the current LED to the active color
+    leds[currentLed] = COLOR;
+
+    // Move to the previous LED
+    currentLed--;
+    if (currentLed < startLed) {
+        currentLed = endLed;  // Loop back to the end LED
+    }
+    return currentLed;
+}
+
 int runningLeds(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR, uint32_t wait, int currentLed, uint32_t& previousMillis, bool& firstRun) {
     uint32_t currentMillis = millis();  // Get the current time
 
@@ -7,40 +49,17 @@ int runningLeds(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR,
     if (currentMillis - previousMillis >= wait) {
         previousMillis = currentMillis;  // Update the last update time
 
-        // Dim the previous LED, but skip on the first run
-        if (!firstRun) {
-            if (currentLed > startLed) {
-                leds[currentLed - 1] = DIMCOLOR;  // Dim the previous LED
-            } else if (currentLed == startLed) {
-                leds[endLed] = DIMCOLOR;  // Dim the last LED when looping back
-            }
-        } else {
-            // On the first run, ensure all LEDs in the range are off
+        // On the first run, ensure all LEDs in the range are off (and skip dimming)
+        if (firstRun) {
             fill_solid(leds + startLed, endLed - startLed + 1, CRGB::Black);
         }
-
-        // Set the current LED to the active color
-        leds[currentLed] = COLOR;
-
-        // Move to the next LED
-        currentLed++;
-        if (currentLed > endLed) {
-            currentLed = startLed;  // Loop back to the start LED
-        }
+        currentLed = chaserStep(leds, startLed, endLed, COLOR, DIMCOLOR, currentLed, !firstRun);
 
         // Mark the first run as complete
         firstRun = false;
     }
 
     return currentLed;  // Return the updated current LED
-    Serial.print("Current LED: ");
-    Serial.println(currentLed);
-    Serial.print("Dimming LED: ");
-    if (currentLed > startLed) {
-        Serial.println(currentLed - 1);
-    } else if (currentLed == startLed) {
-        Serial.println(endLed);
-}
 }
 
 int reverseRunningLeds(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR, uint32_t wait, int currentLed, uint32_t& previousMillis, bool& firstRun) {
@@ -51,26 +70,11 @@ int reverseRunningLeds(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DI
         previousMillis = currentMillis;  // Update the last update time
 
         // Dim the previous LED, but skip on the first run
-        if (!firstRun) {
-            if (currentLed < endLed) {
-                leds[currentLed + 1] = DIMCOLOR;  // Dim the next LED
-            } else if (currentLed == endLed) {
-                leds[startLed] = DIMCOLOR;  // Dim the first LED when looping back
-            }
-        }
-
-        // Set the current LED to the active color
-        leds[currentLed] = COLOR;
-
-        // Move to the previous LED
-        currentLed--;
-        if (currentLed < startLed) {
-            currentLed = endLed;  // Loop back to the end LED
-        }
+        currentLed = reverseChaserStep(leds, startLed, endLed, COLOR, DIMCOLOR, currentLed, !firstRun);
 
         // Mark the first run as complete
         firstRun = false;
     }
 
     return currentLed;  // Return the updated current LED
-}
\ No newline at end of file
+}
@@ -7,4 +7,9 @@
 int runningLeds(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR, uint32_t wait, int currentLed, uint32_t& previousMillis, bool& firstRun);
 int reverseRunningLeds(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR, uint32_t wait, int currentLed, uint32_t& previousMillis, bool& firstRun);
 
-#endif // RUNNINGLED_H
\ No newline at end of file
+// Untimed single chaser step: dim the previously lit LED (unless dimPrevious is false),
+// light currentLed and return the next cursor. The caller decides when to step.
+int chaserStep(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR, int currentLed, bool dimPrevious = true);
+int reverseChaserStep(CRGB* leds, int startLed, int endLed, CRGB COLOR, CRGB DIMCOLOR, int currentLed, bool dimPrevious = true);
+
+#endif // RUNNINGLED_H
@@ -1,12 +1,27 @@
 #include "Hardware.h"
 #include "Config.h"
+#include "OutputStage.h"
+#include "Topology.h"
 #include <Arduino.h>
 
 void hardwareInit(SystemState &state) {
-    // Attach FastLED to the LED buffer owned by the system state
-    FastLED.addLeds<WS2812, DATA_PIN, COLOR_ORDER>(state.leds, NUM_LEDS);
-    fill_solid(state.leds, NUM_LEDS, CRGB::Black);
-    FastLED.show();
+    // Attach FastLED to the output stage's corrected physical buffer; effects draw into state.leds
+    // (the strip length is the one of the profile picked at boot)
+    const ProfileOps &profile = *state.profile;
+    outputStageInit(state.output, profile);
+#ifdef DATA_PIN2
+    // Each pin only clocks out up to its last used pixel; a profile whose strip
+    // ends before the cut drives DATA_PIN only
+    const int firstPin = topologyUsedBelow(profile.runs, profile.runCount, OUTPUT2_FIRST_LED);
+    FastLED.addLeds<WS2812, DATA_PIN, COLOR_ORDER>(state.output.frame, firstPin);
+    if (profile.physicalLeds > OUTPUT2_FIRST_LED) {
+        FastLED.addLeds<WS2812, DATA_PIN2, COLOR_ORDER>(state.output.frame + OUTPUT2_FIRST_LED, profile.physicalLeds - OUTPUT2_FIRST_LED);
+    }
+#else
+    FastLED.addLeds<WS2812, DATA_PIN, COLOR_ORDER>(state.output.frame, profile.physicalLeds);
+#endif
+    fill_solid(state.leds, kMaxLogicalLeds, CRGB::Black);
+    showFrame(state);
 
     pinMode(BUTTON_PIN, INPUT_PULLUP);
     pinMode(BUTTON_LED_PIN, OUTPUT);
@@ -4,362 +4,475 @@
 #include "../../lib/fadeLeds/fadeLeds.h"
 #include "../../lib/runningLed/runningLed.h"
 #include "../../lib/fireEffect/fireEffect.h"
+#include "../../lib/gasFlow/gasFlow.h"
 #include "../../include/SystemState.h"
+#include "../../include/model/HydrogenModel.h"
+#include "../../include/Coroutine.h"
 #include <Arduino.h>
 
-// fadeEffect is owned by the runtime SystemState (state.fadeEffect)
+// fade/fire/gas flow instances live in the SystemState pools and are reached via handles
+
+// Trail colour behind a chaser head, shared by every chaser below
+#define DIM(color) CRGB((color).r / 10, (color).g / 10, (color).b / 10)
 
 // ---- Wind effect
-void updateWindEffect(SystemState &state, Timers &timers) {
-    if (state.windOn) {
-        state.windSegment = runningLeds(
-            state.leds,
-            WIND_LED_START,
-            WIND_LED_END,
-            WIND_COLOR_ACTIVE,
-            CRGB(WIND_COLOR_ACTIVE.r / 10, WIND_COLOR_ACTIVE.g / 10, WIND_COLOR_ACTIVE.b / 10),
-            LED_DELAY,
-            state.windSegment,
-            timers.previousMillisWind,
-            state.firstRunWind
-        );
-        state.solarSegment = reverseRunningLeds(
-            state.leds,
-            SOLAR_LED_START,
-            SOLAR_LED_END,
-            WIND_COLOR_ACTIVE,
-            CRGB(WIND_COLOR_ACTIVE.r / 10, WIND_COLOR_ACTIVE.g / 10, WIND_COLOR_ACTIVE.b / 10),
-            LED_DELAY,
-            state.solarSegment,
-            timers.previousMillisSolar,
-            state.firstRunSolar
-        );
-
-        if (state.windSegment == WIND_LED_END || state.solarSegment == SOLAR_LED_START) {
-            state.electricityProductionOn = true;
-        }
-    } else {
-    clearSegment(state, WIND_LED_START, WIND_LED_END);
-        state.firstRunWind = true;
-        state.windSegment = WIND_LED_START;
+// Chasers run as coroutines (Coroutine.h): each wait is a CO_SLEEP, so the
+// effect returns straight away until its next step is due. The segment
+// cursors stay in SystemState because later stages trigger on them.
 
-    clearSegment(state, SOLAR_LED_START, SOLAR_LED_END);
-        state.firstRunSolar = true;
-        state.solarSegment = SOLAR_LED_END;
+template <typename P>
+void WindEffect<P>::update(SystemState &state, Timers &timers) {
+    const uint32_t now = millis();
+    Coroutine &co = state.windTask;
+    CO_BEGIN(co, now);
+    for (;;) {
+        clearSegment(state, P::windStart, P::windEnd);
+        clearSegment(state, P::solarStart, P::solarEnd);
+        state.windSegment = P::windStart;
+        state.solarSegment = P::solarEnd;
         state.electricityProductionOn = false;
+
+        CO_WAIT_UNTIL(co, state.windOn);
+        state.windSegment = chaserStep(state.leds, P::windStart, P::windEnd, state.look.windColor, DIM(state.look.windColor), state.windSegment, false);
+        state.solarSegment = reverseChaserStep(state.leds, P::solarStart, P::solarEnd, state.look.windColor, DIM(state.look.windColor), state.solarSegment, false);
+        for (;;) {
+            if (state.windSegment == P::windEnd || state.solarSegment == P::solarStart) {
+                state.electricityProductionOn = true;
+            }
+            CO_SLEEP(co, now, lookDelay(state.look.ledDelay, P::ledDelay));
+            if (!state.windOn) break;
+            state.windSegment = chaserStep(state.leds, P::windStart, P::windEnd, state.look.windColor, DIM(state.look.windColor), state.windSegment);
+            state.solarSegment = reverseChaserStep(state.leds, P::solarStart, P::solarEnd, state.look.windColor, DIM(state.look.windColor), state.solarSegment);
+        }
     }
+    CO_END(co);
+}
+
+template <typename P>
+void WindEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.windOn = false;
+    state.solarOn = false;
+    state.windSegment = P::windStart;
+    state.solarSegment = P::solarEnd;
+    coReset(state.windTask);
 }
 
 // ---- Electricity production effect
-void updateElectricityProductionEffect(SystemState &state, Timers &timers) {
-    if (state.electricityProductionOn) {
-        state.electricityProductionSegment = runningLeds(
-            state.leds,
-            ELECTRICITY_PRODUCTION_LED_START,
-            ELECTRICITY_PRODUCTION_LED_END,
-            WIND_COLOR_ACTIVE,
-            CRGB(WIND_COLOR_ACTIVE.r / 10, WIND_COLOR_ACTIVE.g / 10, WIND_COLOR_ACTIVE.b / 10),
-            LED_DELAY,
-            state.electricityProductionSegment,
-            timers.previousMillisElectricityProduction,
-            state.firstRunElectricityProduction
-        );
-
-        if (state.electricityProductionSegment == ELECTRICITY_PRODUCTION_LED_END) {
-            if (!state.electrolyserOn) {
+template <typename P>
+void ElectricityProductionEffect<P>::update(SystemState &state, Timers &timers) {
+    const uint32_t now = millis();
+    Coroutine &co = state.electricityProductionTask;
+    CO_BEGIN(co, now);
+    for (;;) {
+        clearSegment(state, P::electricityProductionStart, P::electricityProductionEnd);
+        state.electricityProductionSegment = P::electricityProductionStart;
+        state.electrolyserOn = false;
+
+        CO_WAIT_UNTIL(co, state.electricityProductionOn);
+        state.electricityProductionSegment = chaserStep(state.leds, P::electricityProductionStart, P::electricityProductionEnd,
+                                                        state.look.windColor, DIM(state.look.windColor), state.electricityProductionSegment, false);
+        for (;;) {
+            if (state.electricityProductionSegment == P::electricityProductionEnd) {
                 state.electrolyserOn = true;
-                timers.previousMillisElectrolyser = millis();
             }
+            CO_SLEEP(co, now, lookDelay(state.look.ledDelay, P::ledDelay));
+            if (!state.electricityProductionOn) break;
+            state.electricityProductionSegment = chaserStep(state.leds, P::electricityProductionStart, P::electricityProductionEnd,
+                                                            state.look.windColor, DIM(state.look.windColor), state.electricityProductionSegment);
         }
-    } else {
-        clearSegment(state, ELECTRICITY_PRODUCTION_LED_START, ELECTRICITY_PRODUCTION_LED_END);
-        state.firstRunElectricityProduction = true;
-        state.electricityProductionSegment = ELECTRICITY_PRODUCTION_LED_START;
-        state.electrolyserOn = false;
     }
+    CO_END(co);
 }
 
-// ---- Electrolyser
-void updateElectrolyserEffect(SystemState &state, Timers &timers) {
-    if (state.electrolyserOn) {
-        if (millis() - timers.previousMillisElectrolyser >= HYDROGEN_PRODUCTION_DELAY_MS) {
+template <typename P>
+void ElectricityProductionEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.electricityProductionOn = false;
+    state.electricityProductionSegment = P::electricityProductionStart;
+    coReset(state.electricityProductionTask);
+}
+
+// ---- Electrolyser: hydrogen production starts P::hydrogenProductionDelayMs after power arrives
+template <typename P>
+void ElectrolyserEffect<P>::update(SystemState &state, Timers &timers) {
+    const uint32_t now = millis();
+    Coroutine &co = state.electrolyserTask;
+    CO_BEGIN(co, now);
+    for (;;) {
+        state.hydrogenProductionOn = false;
+        CO_WAIT_UNTIL(co, state.electrolyserOn);
+        CO_SLEEP(co, now, P::hydrogenProductionDelayMs);
+        if (state.electrolyserOn) {
             state.hydrogenProductionOn = true;
+            CO_WAIT_UNTIL(co, !state.electrolyserOn);
         }
-    } else {
-        state.hydrogenProductionOn = false;
     }
+    CO_END(co);
+}
+
+template <typename P>
+void ElectrolyserEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.electrolyserOn = false;
+    coReset(state.electrolyserTask);
 }
 
 // ---- Hydrogen production/transport/storage/consumption (moved here)
-void updateHydrogenProductionEffect(SystemState &state, Timers &timers) {
+template <typename P>
+void HydrogenProductionEffect<P>::update(SystemState &state, Timers &timers) {
     if (state.hydrogenProductionOn) {
-        if (state.fadeEffect) {
-            state.fadeEffect->update(state.leds, HYDROGEN_PRODUCTION_LED_START, HYDROGEN_PRODUCTION_LED_END, HYDROGEN_PRODUCTION_COLOR_ACTIVE, state.firstRunHydrogenProduction);
+        if (fadeLeds *fade = state.fades.get(state.hydrogenProductionFade)) {
+            fade->update(state.leds, P::hydrogenProductionStart, P::hydrogenProductionEnd, state.look.hydrogenProductionColor, state.firstRunHydrogenProduction);
         }
         state.hydrogenTransportOn = true;
     } else {
-    clearSegment(state, HYDROGEN_PRODUCTION_LED_START, HYDROGEN_PRODUCTION_LED_END);
+    clearSegment(state, P::hydrogenProductionStart, P::hydrogenProductionEnd);
         state.firstRunHydrogenProduction = true;
         state.hydrogenTransportOn = false;
     }
 }
 
-void updateHydrogenTransportEffect(SystemState &state, Timers &timers) {
+template <typename P>
+void HydrogenProductionEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.hydrogenProductionOn = false;
+    state.firstRunHydrogenProduction = true;
+}
+
+// Gas packets are drawn by pooled gasFlow particle systems. Flow speed,
+// density and storage fill level come from the hydrogen model (state.model).
+// Below full quality (FrameGovernor.h) packets are drawn without anti-aliasing.
+// The segment cursors in SystemState track the leading gas so the stage
+// transitions below fire when the gas actually arrives.
+template <typename P>
+void HydrogenTransportEffect<P>::update(SystemState &state, Timers &timers) {
+    gasFlow *flow = state.flows.get(state.hydrogenTransportFlow);
+    if (!flow) return;
+    flow->setSmooth(state.governor.level == QUALITY_FULL);
+    const int length = P::hydrogenTransportEnd - P::hydrogenTransportStart + 1;
+
     if (state.hydrogenTransportOn) {
-        state.hydrogenTransportSegment = runningLeds(
-            state.leds,
-            HYDROGEN_TRANSPORT_LED_START,
-            HYDROGEN_TRANSPORT_LED_END,
-            HYDROGEN_PRODUCTION_COLOR_ACTIVE,
-            CRGB(HYDROGEN_PRODUCTION_COLOR_ACTIVE.r / 10, HYDROGEN_PRODUCTION_COLOR_ACTIVE.g / 10, HYDROGEN_PRODUCTION_COLOR_ACTIVE.b / 10),
-            LED_DELAY,
-            state.hydrogenTransportSegment,
-            timers.previousMillisHydrogenTransport,
-            state.firstRunHydrogenTransport
-        );
-
-        if (state.hydrogenTransportSegment == HYDROGEN_TRANSPORT_LED_MID) {
+        flow->setFlow(hydrogenModelFlowSpeed(state.model.productionGps), hydrogenModelFlowDensity(state.model.productionGps));
+        flow->setEmitting(true);
+        flow->setOutletOpen(true);
+        flow->update(length);
+        flow->render(state.leds, P::hydrogenTransportStart, P::hydrogenTransportEnd, state.look.hydrogenProductionColor, CRGB::Black);
+
+        int front = flow->front();
+        state.hydrogenTransportSegment = P::hydrogenTransportStart + (front < 0 ? 0 : front);
+
+        if (state.hydrogenTransportSegment >= P::hydrogenTransportMid) {
             state.h2ConsumptionOn = true;
         }
-        if (state.hydrogenTransportSegment == HYDROGEN_TRANSPORT_LED_END) {
+        if (state.hydrogenTransportSegment >= P::hydrogenTransportEnd) {
             state.hydrogenStorageOn = true;
             state.emptyPipe = true;
         }
     } else if (state.hydrogenStorageFull) {
-        if (state.hydrogenTransportSegment == HYDROGEN_TRANSPORT_LED_START) {
-            state.pipeEmpty = true;
-        }
+        // Production stopped with full storage: stop feeding the pipe and let it drain
+        flow->setEmitting(false);
+        flow->setOutletOpen(true);
+        flow->update(length);
+        flow->render(state.leds, P::hydrogenTransportStart, P::hydrogenTransportEnd, state.look.hydrogenProductionColor,
+                     CRGB(state.look.hydrogenStorageColor.r / 20, state.look.hydrogenStorageColor.g / 20, state.look.hydrogenStorageColor.b / 20));
 
-        if (state.emptyPipe) {
-            fill_solid(state.leds + HYDROGEN_TRANSPORT_LED_START, HYDROGEN_TRANSPORT_LED_END - HYDROGEN_TRANSPORT_LED_START + 1,
-                       CRGB(HYDROGEN_STORAGE_COLOR_ACTIVE.r / 20, HYDROGEN_STORAGE_COLOR_ACTIVE.g / 20, HYDROGEN_STORAGE_COLOR_ACTIVE.b / 20));
-            state.hydrogenTransportSegment = HYDROGEN_TRANSPORT_LED_START;
+        if (state.emptyPipe && flow->empty()) {
             state.emptyPipe = false;
+            state.pipeEmpty = true;
         }
-
-        if (!state.pipeEmpty) {
-            state.hydrogenTransportSegment = runningLeds(
-                state.leds,
-                HYDROGEN_TRANSPORT_LED_START,
-                HYDROGEN_TRANSPORT_LED_END,
-                HYDROGEN_PRODUCTION_COLOR_ACTIVE,
-                CRGB::Black,
-                LED_DELAY,
-                state.hydrogenTransportSegment,
-                timers.previousMillisHydrogenTransport,
-                state.firstRunHydrogenTransport
-            );
-        } else {
-            clearSegment(state, HYDROGEN_TRANSPORT_LED_START, HYDROGEN_TRANSPORT_LED_END);
+        if (state.pipeEmpty) {
+            clearSegment(state, P::hydrogenTransportStart, P::hydrogenTransportEnd);
         }
-
+        state.hydrogenTransportSegment = P::hydrogenTransportStart;
         state.hydrogenStorageOn = false;
     } else {
         // reset
-        state.firstRunHydrogenTransport = true;
-        state.hydrogenTransportSegment = HYDROGEN_TRANSPORT_LED_START;
+        flow->reset();
+        clearSegment(state, P::hydrogenTransportStart, P::hydrogenTransportEnd);
+        state.hydrogenTransportSegment = P::hydrogenTransportStart;
         state.hydrogenStorageOn = false;
         state.emptyPipe = false;
         state.pipeEmpty = false;
     }
 }
 
-void updateHydrogenStorageEffect(SystemState &state, Timers &timers) {
+template <typename P>
+void HydrogenTransportEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.hydrogenTransportOn = false;
+    state.hydrogenTransportSegment = P::hydrogenTransportStart;
+    state.emptyPipe = false;
+    state.pipeEmpty = false;
+}
+
+// Drain sequence once the tanks are full: stop feeding consumption, hold the
+// stored gas for P::hydrogenStorageDelayMs, then open the outlets.
+template <typename P>
+static void storageDrainTask(SystemState &state, gasFlow &tank1, gasFlow &tank2, uint32_t now) {
+    Coroutine &co = state.storageDrainTask;
+    CO_BEGIN(co, now);
+    state.h2ConsumptionOn = false;
+    tank1.setEmitting(false);
+    tank2.setEmitting(false);
+    CO_SLEEP(co, now, P::hydrogenStorageDelayMs);
+    state.storageDraining = true;
+    tank1.setOutletOpen(true);
+    tank2.setOutletOpen(true);
+    CO_END(co);
+}
+
+template <typename P>
+void HydrogenStorageEffect<P>::update(SystemState &state, Timers &timers) {
+    gasFlow *tank1 = state.flows.get(state.hydrogenStorageFlow1);
+    gasFlow *tank2 = state.flows.get(state.hydrogenStorageFlow2);
+    if (!tank1 || !tank2) return;
+    tank1->setSmooth(state.governor.level == QUALITY_FULL);
+    tank2->setSmooth(state.governor.level == QUALITY_FULL);
+    const int length1 = P::hydrogenStorage1End - P::hydrogenStorage1Start + 1;
+    const int length2 = P::hydrogenStorage2End - P::hydrogenStorage2Start + 1;
+    const CRGB dim = CRGB(state.look.hydrogenStorageColor.r / 10, state.look.hydrogenStorageColor.g / 10, state.look.hydrogenStorageColor.b / 10);
+
     if (state.hydrogenStorageOn) {
-        state.hydrogenStorageSegment1 = runningLeds(
-            state.leds,
-            HYDROGEN_STORAGE1_LED_START,
-            HYDROGEN_STORAGE1_LED_END,
-            HYDROGEN_STORAGE_COLOR_ACTIVE,
-            CRGB(HYDROGEN_STORAGE_COLOR_ACTIVE.r / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.g / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.b / 10),
-            LED_DELAY,
-            state.hydrogenStorageSegment1,
-            timers.previousMillisHydrogenStorage,
-            state.firstRunHydrogenStorage
-        );
-        state.hydrogenStorageSegment2 = runningLeds(
-            state.leds,
-            HYDROGEN_STORAGE2_LED_START,
-            HYDROGEN_STORAGE2_LED_END,
-            HYDROGEN_STORAGE_COLOR_ACTIVE,
-            CRGB(HYDROGEN_STORAGE_COLOR_ACTIVE.r / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.g / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.b / 10),
-            LED_DELAY,
-            state.hydrogenStorageSegment2,
-            timers.previousMillisHydrogenStorage2,
-            state.firstRunHydrogenStorage2
-        );
-
-        if (state.hydrogenStorageSegment1 == HYDROGEN_STORAGE1_LED_END) {
+        // Filling: the outlets are closed so the gas settles and the tanks fill up
+        const q16_t inflow = state.model.storageInflowGps;
+        tank1->setFlow(hydrogenModelFlowSpeed(inflow), hydrogenModelFlowDensity(inflow));
+        tank2->setFlow(hydrogenModelFlowSpeed(inflow), hydrogenModelFlowDensity(inflow));
+        tank1->setEmitting(true);
+        tank2->setEmitting(true);
+        tank1->setOutletOpen(false);
+        tank2->setOutletOpen(false);
+        // The model owns the fill level; the particles only show the flow into and out of it
+        tank1->setFillLevel(hydrogenModelStorageFill(state.model, length1));
+        tank2->setFillLevel(hydrogenModelStorageFill(state.model, length2));
+        tank1->update(length1);
+        tank2->update(length2);
+        tank1->render(state.leds, P::hydrogenStorage1Start, P::hydrogenStorage1End, state.look.hydrogenStorageColor, CRGB::Black);
+        tank2->render(state.leds, P::hydrogenStorage2Start, P::hydrogenStorage2End, state.look.hydrogenStorageColor, CRGB::Black);
+
+        if (hydrogenModelStorageFull(state.model)) {
             state.hydrogenStorageFull = true;
         }
     } else if (state.hydrogenStorageFull) {
-        if (!state.storageTimerStarted) {
-            state.h2ConsumptionOn = false;
-            fill_solid(state.leds + HYDROGEN_STORAGE1_LED_START, HYDROGEN_STORAGE1_LED_END - HYDROGEN_STORAGE1_LED_START + 1, CRGB(HYDROGEN_STORAGE_COLOR_ACTIVE.r / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.g / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.b / 10));
-            fill_solid(state.leds + HYDROGEN_STORAGE2_LED_START, HYDROGEN_STORAGE2_LED_END - HYDROGEN_STORAGE2_LED_START + 1, CRGB(HYDROGEN_STORAGE_COLOR_ACTIVE.r / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.g / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.b / 10));
-            state.h2ConsumptionSegment = HYDROGEN_CONSUMPTION_LED_START;
-            state.hydrogenStorageSegment1 = HYDROGEN_STORAGE1_LED_END;
-            state.hydrogenStorageSegment2 = HYDROGEN_STORAGE2_LED_END;
-            timers.hydrogenStorageFullTimer = millis();
-            state.storageTimerStarted = true;
-        }
-        if (millis() - timers.hydrogenStorageFullTimer >= HYDROGEN_STORAGE_DELAY_MS) {
-            state.hydrogenStorageSegment1 = reverseRunningLeds(
-                state.leds,
-                HYDROGEN_STORAGE1_LED_START,
-                HYDROGEN_STORAGE1_LED_END,
-                HYDROGEN_STORAGE_COLOR_ACTIVE,
-                CRGB(HYDROGEN_STORAGE_COLOR_ACTIVE.r / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.g / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.b / 10),
-                LED_DELAY,
-                state.hydrogenStorageSegment1,
-                timers.previousMillisHydrogenStorage,
-                state.firstRunHydrogenStorage
-            );
-            state.hydrogenStorageSegment2 = reverseRunningLeds(
-                state.leds,
-                HYDROGEN_STORAGE2_LED_START,
-                HYDROGEN_STORAGE2_LED_END,
-                HYDROGEN_STORAGE_COLOR_ACTIVE,
-                CRGB(HYDROGEN_STORAGE_COLOR_ACTIVE.r / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.g / 10, HYDROGEN_STORAGE_COLOR_ACTIVE.b / 10),
-                LED_DELAY,
-                state.hydrogenStorageSegment2,
-                timers.previousMillisHydrogenStorage2,
-                state.firstRunHydrogenStorage2
-            );
+        // Hold the stored gas, then drain into storage transport at the modelled outflow
+        storageDrainTask<P>(state, *tank1, *tank2, millis());
+        if (state.storageDraining) {
+            const q16_t outflow = state.model.storageOutflowGps;
+            tank1->setFlow(hydrogenModelFlowSpeed(outflow), 0);
+            tank2->setFlow(hydrogenModelFlowSpeed(outflow), 0);
         }
-        if (state.hydrogenStorageSegment1 == HYDROGEN_STORAGE1_LED_START || state.hydrogenStorageSegment2 == HYDROGEN_STORAGE2_LED_START) {
+        tank1->setFillLevel(hydrogenModelStorageFill(state.model, length1));
+        tank2->setFillLevel(hydrogenModelStorageFill(state.model, length2));
+        tank1->update(length1);
+        tank2->update(length2);
+        tank1->render(state.leds, P::hydrogenStorage1Start, P::hydrogenStorage1End, state.look.hydrogenStorageColor, dim);
+        tank2->render(state.leds, P::hydrogenStorage2Start, P::hydrogenStorage2End, state.look.hydrogenStorageColor, dim);
+
+        if (state.model.storageOutflowGps > 0) {
             state.storageTransportOn = true;
         }
     } else {
-    clearSegment(state, HYDROGEN_STORAGE1_LED_START, HYDROGEN_STORAGE1_LED_END);
-    clearSegment(state, HYDROGEN_STORAGE2_LED_START, HYDROGEN_STORAGE2_LED_END);
-        state.firstRunHydrogenStorage = true;
-        state.firstRunHydrogenStorage2 = true;
-        state.hydrogenStorageSegment1 = HYDROGEN_STORAGE1_LED_START;
-        state.hydrogenStorageSegment2 = HYDROGEN_STORAGE2_LED_START;
+        tank1->reset();
+        tank2->reset();
+        clearSegment(state, P::hydrogenStorage1Start, P::hydrogenStorage1End);
+        clearSegment(state, P::hydrogenStorage2Start, P::hydrogenStorage2End);
         state.storageTransportOn = false;
-        state.storageTimerStarted = false;
+        state.storageDraining = false;
+        coReset(state.storageDrainTask);
     }
 }
 
-void updateH2ConsumptionEffect(SystemState &state, Timers &timers) {
+template <typename P>
+void HydrogenStorageEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.hydrogenStorageOn = false;
+    state.hydrogenStorageFull = false;
+    state.storageDraining = false;
+    coReset(state.storageDrainTask);
+}
+
+template <typename P>
+void H2ConsumptionEffect<P>::update(SystemState &state, Timers &timers) {
+    gasFlow *flow = state.flows.get(state.h2ConsumptionFlow);
+    if (!flow) return;
+    flow->setSmooth(state.governor.level == QUALITY_FULL);
+    const int length = P::hydrogenConsumptionEnd - P::hydrogenConsumptionStart + 1;
+
     if (state.h2ConsumptionOn) {
-        state.h2ConsumptionSegment = runningLeds(
-            state.leds,
-            HYDROGEN_CONSUMPTION_LED_START,
-            HYDROGEN_CONSUMPTION_LED_END,
-            HYDROGEN_CONSUMPTION_COLOR_ACTIVE,
-            CRGB(HYDROGEN_CONSUMPTION_COLOR_ACTIVE.r / 10, HYDROGEN_CONSUMPTION_COLOR_ACTIVE.g / 10, HYDROGEN_CONSUMPTION_COLOR_ACTIVE.b / 10),
-            LED_DELAY,
-            state.h2ConsumptionSegment,
-            timers.previousMillisH2Consumption,
-            state.firstRunH2Consumption
-        );
-
-        if (state.h2ConsumptionSegment == HYDROGEN_CONSUMPTION_LED_END) {
+        flow->setFlow(hydrogenModelFlowSpeed(state.model.consumptionGps), hydrogenModelFlowDensity(state.model.consumptionGps));
+        flow->setEmitting(true);
+        flow->setOutletOpen(true);
+        flow->update(length);
+        flow->render(state.leds, P::hydrogenConsumptionStart, P::hydrogenConsumptionEnd, state.look.hydrogenConsumptionColor, CRGB::Black);
+
+        int front = flow->front();
+        state.h2ConsumptionSegment = P::hydrogenConsumptionStart + (front < 0 ? 0 : front);
+
+        if (state.h2ConsumptionSegment >= P::hydrogenConsumptionEnd) {
             state.fabricationOn = true;
         }
     } else if (state.storageTransportOn) {
-        if (state.storageTransportSegment == STORAGE_TRANSPORT_LED_END) {
+        // Supply switched over to storage: whatever is left in the pipe drains out
+        flow->setEmitting(false);
+        flow->update(length);
+        flow->render(state.leds, P::hydrogenConsumptionStart, P::hydrogenConsumptionEnd, state.look.hydrogenConsumptionColor, CRGB::Black);
+        if (state.storageTransportSegment == P::storageTransportEnd) {
             state.fabricationOn = true;
         }
     } else {
-    clearSegment(state, HYDROGEN_CONSUMPTION_LED_START, HYDROGEN_CONSUMPTION_LED_END);
-        state.firstRunH2Consumption = true;
-        state.h2ConsumptionSegment = HYDROGEN_CONSUMPTION_LED_START;
+        flow->reset();
+        clearSegment(state, P::hydrogenConsumptionStart, P::hydrogenConsumptionEnd);
+        state.h2ConsumptionSegment = P::hydrogenConsumptionStart;
         state.fabricationOn = false;
     }
 }
 
+template <typename P>
+void H2ConsumptionEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.h2ConsumptionOn = false;
+    state.h2ConsumptionSegment = P::hydrogenConsumptionStart;
+}
+
 // ---- Fabrication effect
-void updateFabricationEffect(SystemState &state, Timers &timers) {
+template <typename P>
+void FabricationEffect<P>::update(SystemState &state, Timers &timers) {
     if (state.fabricationOn) {
-        fireEffect(state.leds, FABRICATION_LED_START, FABRICATION_LED_END);
+        if (fireLeds *fire = state.fires.get(state.fabricationFire)) {
+            // the fire steps less often while the frame governor is saving time
+            fire->setWait(state.governor.level == QUALITY_FULL ? FIRE_WAIT_MS : GOVERNOR_FIRE_WAIT_MS);
+            fire->setShape(state.look.fireCooling, state.look.fireSparking);
+            fire->update(state.leds, P::fabricationStart, P::fabricationEnd);
+        }
     } else {
-        clearSegment(state, FABRICATION_LED_START, FABRICATION_LED_END);
+        clearSegment(state, P::fabricationStart, P::fabricationEnd);
     }
 }
 
+template <typename P>
+void FabricationEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.fabricationOn = false;
+}
+
 // ---- Storage transport / powerstation
-void updateStorageTransportEffect(SystemState &state, Timers &timers) {
-    if (state.storageTransportOn) {
-        state.storageTransportSegment = runningLeds(
-            state.leds,
-            STORAGE_TRANSPORT_LED_START,
-            STORAGE_TRANSPORT_LED_END,
-            HYDROGEN_CONSUMPTION_COLOR_ACTIVE,
-            CRGB(HYDROGEN_CONSUMPTION_COLOR_ACTIVE.r / 10, HYDROGEN_CONSUMPTION_COLOR_ACTIVE.g / 10, HYDROGEN_CONSUMPTION_COLOR_ACTIVE.b / 10),
-            LED_DELAY2,
-            state.storageTransportSegment,
-            timers.previousMillisStorageTransport,
-            state.firstRunStorageTransport
-        );
-        if (state.storageTransportSegment == STORAGE_TRANSPORT_LED_END) {
-            state.storagePowerstationOn = true;
-        }
-        if (state.storagePowerstationOn) {
-            state.storagePowerstationSegment = runningLeds(
-                state.leds,
-                STORAGE_POWERSTATION_LED_START,
-                STORAGE_POWERSTATION_LED_END,
-                HYDROGEN_CONSUMPTION_COLOR_ACTIVE,
-                CRGB(HYDROGEN_CONSUMPTION_COLOR_ACTIVE.r / 10, HYDROGEN_CONSUMPTION_COLOR_ACTIVE.g / 10, HYDROGEN_CONSUMPTION_COLOR_ACTIVE.b / 10),
-                LED_DELAY2,
-                state.storagePowerstationSegment,
-                timers.previousMillisStoragePowerstation,
-                state.firstRunStoragePowerstation
-            );
-        }
-        if (state.storagePowerstationSegment == STORAGE_POWERSTATION_LED_END) {
-            state.electricityTransportOn = true;
-            Serial.println("Electricity transport enabled");
-        }
-    } else {
-        clearSegment(state, STORAGE_TRANSPORT_LED_START, STORAGE_TRANSPORT_LED_END);
-        state.firstRunStorageTransport = true;
-        state.storageTransportSegment = STORAGE_TRANSPORT_LED_START;
-        clearSegment(state, STORAGE_POWERSTATION_LED_START, STORAGE_POWERSTATION_LED_END);
-        state.firstRunStoragePowerstation = true;
-        state.storagePowerstationSegment = STORAGE_POWERSTATION_LED_START;
+// The powerstation chaser starts when the transport chaser reaches its end,
+// and both then step together every P::ledDelay2.
+template <typename P>
+void StorageTransportEffect<P>::update(SystemState &state, Timers &timers) {
+    const uint32_t now = millis();
+    Coroutine &co = state.storageTransportTask;
+    CO_BEGIN(co, now);
+    for (;;) {
+        clearSegment(state, P::storageTransportStart, P::storageTransportEnd);
+        clearSegment(state, P::storagePowerstationStart, P::storagePowerstationEnd);
+        state.storageTransportSegment = P::storageTransportStart;
+        state.storagePowerstationSegment = P::storagePowerstationStart;
         state.storagePowerstationOn = false;
+
+        CO_WAIT_UNTIL(co, state.storageTransportOn);
+        state.storageTransportSegment = chaserStep(state.leds, P::storageTransportStart, P::storageTransportEnd,
+                                                   state.look.hydrogenConsumptionColor, DIM(state.look.hydrogenConsumptionColor), state.storageTransportSegment, false);
+        for (;;) {
+            if (state.storageTransportSegment == P::storageTransportEnd && !state.storagePowerstationOn) {
+                state.storagePowerstationOn = true;
+                state.storagePowerstationSegment = chaserStep(state.leds, P::storagePowerstationStart, P::storagePowerstationEnd,
+                                                              state.look.hydrogenConsumptionColor, DIM(state.look.hydrogenConsumptionColor), state.storagePowerstationSegment, false);
+            }
+            if (state.storagePowerstationSegment == P::storagePowerstationEnd && !state.electricityTransportOn) {
+                state.electricityTransportOn = true;
+                Serial.println("Electricity transport enabled");
+            }
+            CO_SLEEP(co, now, lookDelay(state.look.ledDelay2, P::ledDelay2));
+            if (!state.storageTransportOn) break;
+            state.storageTransportSegment = chaserStep(state.leds, P::storageTransportStart, P::storageTransportEnd,
+                                                       state.look.hydrogenConsumptionColor, DIM(state.look.hydrogenConsumptionColor), state.storageTransportSegment);
+            if (state.storagePowerstationOn) {
+                state.storagePowerstationSegment = chaserStep(state.leds, P::storagePowerstationStart, P::storagePowerstationEnd,
+                                                              state.look.hydrogenConsumptionColor, DIM(state.look.hydrogenConsumptionColor), state.storagePowerstationSegment);
+            }
+        }
     }
+    CO_END(co);
+}
+
+template <typename P>
+void StorageTransportEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.storageTransportOn = false;
+    state.storagePowerstationOn = false;
+    state.storageTransportSegment = P::storageTransportStart;
+    state.storagePowerstationSegment = P::storagePowerstationStart;
+    coReset(state.storageTransportTask);
 }
 
 // ---- Electricity transport
-void updateElectricityEffect(SystemState &state, Timers &timers) {
-    if (state.electricityTransportOn) {
-        state.electricityTransportSegment = runningLeds(
-            state.leds,
-            ELECTRICITY_TRANSPORT_LED_START,
-            ELECTRICITY_TRANSPORT_LED_END,
-            ELECTRICITY_TRANSPORT_COLOR_ACTIVE,
-            CRGB(ELECTRICITY_TRANSPORT_COLOR_ACTIVE.r / 10, ELECTRICITY_TRANSPORT_COLOR_ACTIVE.g / 10, ELECTRICITY_TRANSPORT_COLOR_ACTIVE.b / 10),
-            LED_DELAY,
-            state.electricityTransportSegment,
-            timers.previousMillisElectricityTransport,
-            state.firstRunElectricityTransport
-        );
-
-        if (state.electricityTransportSegment == ELECTRICITY_TRANSPORT_LED_END) {
-            digitalWrite(STREET_LED_PIN, HIGH);
-            state.streetLightOn = true;
-        }
-    } else {
-    clearSegment(state, ELECTRICITY_TRANSPORT_LED_START, ELECTRICITY_TRANSPORT_LED_END);
-        state.firstRunElectricityTransport = true;
-        state.electricityTransportSegment = ELECTRICITY_TRANSPORT_LED_START;
+template <typename P>
+void ElectricityEffect<P>::update(SystemState &state, Timers &timers) {
+    const uint32_t now = millis();
+    Coroutine &co = state.electricityTransportTask;
+    CO_BEGIN(co, now);
+    for (;;) {
+        clearSegment(state, P::electricityTransportStart, P::electricityTransportEnd);
+        state.electricityTransportSegment = P::electricityTransportStart;
         digitalWrite(STREET_LED_PIN, LOW);
         state.streetLightOn = false;
+
+        CO_WAIT_UNTIL(co, state.electricityTransportOn);
+        state.electricityTransportSegment = chaserStep(state.leds, P::electricityTransportStart, P::electricityTransportEnd,
+                                                       state.look.electricityTransportColor, DIM(state.look.electricityTransportColor), state.electricityTransportSegment, false);
+        for (;;) {
+            if (state.electricityTransportSegment == P::electricityTransportEnd && !state.streetLightOn) {
+                digitalWrite(STREET_LED_PIN, HIGH);
+                state.streetLightOn = true;
+            }
+            CO_SLEEP(co, now, lookDelay(state.look.ledDelay, P::ledDelay));
+            if (!state.electricityTransportOn) break;
+            state.electricityTransportSegment = chaserStep(state.leds, P::electricityTransportStart, P::electricityTransportEnd,
+                                                           state.look.electricityTransportColor, DIM(state.look.electricityTransportColor), state.electricityTransportSegment);
+        }
     }
+    CO_END(co);
+}
+
+template <typename P>
+void ElectricityEffect<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    state.electricityTransportOn = false;
+    state.streetLightOn = false;
+    state.electricityTransportSegment = P::electricityTransportStart;
+    coReset(state.electricityTransportTask);
 }
 
 // ---- Information LEDs
-void updateInformationLEDs(SystemState &state, Timers &timers) {
-    setPixelSafe(state, WIND_INFO_LED, state.windOn ? CRGB::Red : CRGB::Black);
-    setPixelSafe(state, HYDROGEN_PRODUCTION_INFO_LED, state.hydrogenProductionOn ? CRGB::Red : CRGB::Black);
-    setPixelSafe(state, ELECTROLYSER_INFO_LED, state.electrolyserOn ? CRGB::Red : CRGB::Black);
-    setPixelSafe(state, HYDROGEN_STORAGE_INFO_LED, state.hydrogenStorageOn ? CRGB::Red : CRGB::Black);
-    setPixelSafe(state, HYDROGEN_CONSUMPTION_INFO_LED, state.h2ConsumptionOn ? CRGB::Red : CRGB::Black);
-    setPixelSafe(state, ELECTRICITY_TRANSPORT_INFO_LED, state.electricityTransportOn ? CRGB::Red : CRGB::Black);
-    setPixelSafe(state, STREET_LED, state.streetLightOn ? CRGB::Red : CRGB::Black);
+template <typename P>
+void InformationLEDs<P>::update(SystemState &state, Timers &timers) {
+    setPixelSafe(state, P::windInfoLed, state.windOn ? CRGB::Red : CRGB::Black);
+    setPixelSafe(state, P::hydrogenProductionInfoLed, state.hydrogenProductionOn ? CRGB::Red : CRGB::Black);
+    setPixelSafe(state, P::electrolyserInfoLed, state.electrolyserOn ? CRGB::Red : CRGB::Black);
+    setPixelSafe(state, P::hydrogenStorageInfoLed, state.hydrogenStorageOn ? CRGB::Red : CRGB::Black);
+    setPixelSafe(state, P::hydrogenConsumptionInfoLed, state.h2ConsumptionOn ? CRGB::Red : CRGB::Black);
+    setPixelSafe(state, P::electricityTransportInfoLed, state.electricityTransportOn ? CRGB::Red : CRGB::Black);
+    setPixelSafe(state, P::streetLed, state.streetLightOn ? CRGB::Red : CRGB::Black);
+}
+
+template <typename P>
+void InformationLEDs<P>::reset(SystemState &state, Timers &timers, uint32_t now) {
+    // stateless: the indicators follow the stage flags every frame
+}
+
+// ---- Registry-driven update/reset (expanded at compile time, see EffectRegistry.h)
+template <typename P>
+void updateSegmentsFor(SystemState &state, Timers &timers) {
+    SegmentEffects<P>::update(state, timers);
+}
+
+template <typename P>
+void resetSegmentsFor(SystemState &state, Timers &timers, uint32_t now) {
+    SegmentEffects<P>::reset(state, timers, now);
+}
+
+// One specialised copy of the whole segment update per profile
+#define PROFILE_INSTANTIATE_EFFECTS(P)                                    \
+    template void updateSegmentsFor<P>(SystemState &, Timers &);          \
+    template void resetSegmentsFor<P>(SystemState &, Timers &, uint32_t);
+PROFILE_LIST(PROFILE_INSTANTIATE_EFFECTS)
+
+// The active profile was chosen at boot; this is the only indirect call per frame
+void updateSegments(SystemState &state, Timers &timers) {
+    state.profile->update(state, timers);
+}
+
+void resetSegments(SystemState &state, Timers &timers, uint32_t now) {
+    state.profile->reset(state, timers, now);
 }
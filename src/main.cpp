@@ -6,6 +6,17 @@
 #include "LEDs.h"
 #include "effects/Effects.h"
 #include "SystemState.h"
+#include "model/HydrogenModel.h"
+#include "OutputStage.h"
+#include "MemoryReport.h"
+#include "Profiles.h"
+#include "FrameGovernor.h"
+#include "DemoCycle.h"
+#if IDLE_CLIP
+#include "ClipPlayer.h"
+#include "clips/IdleClip.h"
+static_assert(kIdleClipPixels <= kMaxLogicalLeds, "IdleClip.h was rendered for a larger LED table");
+#endif
 
 // ========================== Global state ==========================
 // LED buffer moved into SystemState (state.leds)
@@ -14,168 +25,137 @@
 SystemState state;
 Timers timers;
 
+// Serial profile command in progress: 'p' seen, then the argument ('0'-'9' or 'x')
+static bool profileCommand = false;
+static int profileArgument = 0;
+
 // ========================== Helpers ==========================
 // LED helpers moved to `src/utils/LEDs.cpp` (declared in include/LEDs.h)
 
 // ========================== Declarations ==========================
-void updateSegments();
-void updateRelays();
-void checkButtonState();
-void resetAllVariables();
+bool updateIdleClip(SystemState &state);
+void handleSerialCommands();
+void printProfiles();
 
 // ========================== Setup & Loop ==========================
 void setup() {
+#if FRAME_MIRROR
+    // room for a whole keyframe; the default leaves only the hardware FIFO
+    Serial.setTxBufferSize(FRAME_MIRROR_TX_BUFFER);
+#endif
     Serial.begin(115200);
+    // the table profile (layout, wiring, timings) is fixed from here on
+    state.profile = &profileSelect();
+    Serial.print("Profile: ");
+    Serial.println(state.profile->name);
     hardwareInit(state);
-    // run a quick LED test (chase from 0..NUM_LEDS-1) so we can verify wiring
+    // run a quick LED test (chase over the profile's logical LEDs) so we can verify wiring
     testAllLeds(state, 20);
-    // allocate and initialize fadeEffect owned by the state
-    state.fadeEffect = new fadeLeds(2000);
-    digitalWrite(BUTTON_LED_PIN, HIGH);
-    resetAllVariables();
+    // take the effect instances used by the flow from the state's static pools
+    demoCycleBegin(state, timers);
+#if IDLE_CLIP
+    // a clip rendered for another profile's layout can't be shown; fall back to the live animation
+    if (kIdleClipPixels != state.profile->logicalLeds) state.windOn = true;
+#else
     state.windOn = true;
+#endif
 }
 
 void loop() {
-    checkButtonState();
-    updateSegments();
-    updateRelays();
-    FastLED.show();
+    handleSerialCommands();
+    demoCyclePass(state, timers, updateIdleClip);
 }
 
 // ========================== Implementations ==========================
 // hardware initialization moved to src/Hardware.cpp (hardwareInit)
-
-void updateSegments() {
-    updateWindEffect(state, timers);
-    updateElectricityProductionEffect(state, timers);
-    updateElectrolyserEffect(state, timers);
-    updateHydrogenProductionEffect(state, timers);
-    updateHydrogenTransportEffect(state, timers);
-    updateHydrogenStorageEffect(state, timers);
-    updateH2ConsumptionEffect(state, timers);
-    updateFabricationEffect(state, timers);
-    updateElectricityEffect(state, timers);
-    updateStorageTransportEffect(state, timers);
-    // Update the small information LEDs (status indicators)
-    updateInformationLEDs(state, timers);
-}
-
-void updateRelays() {
-    digitalWrite(WIND_TURBINE_RELAY_PIN, state.windOn ? HIGH : LOW);
-    digitalWrite(ELECTROLYSER_RELAY_PIN, state.electrolyserOn ? HIGH : LOW);
-}
+// button handling and the run timeout moved to src/utils/DemoCycle.cpp
 
 // Effect implementations are provided in src/effects/Effects.cpp
 
-void checkButtonState() {
-    uint32_t currentMillis = millis();
-    // if general timer active handle timeouts
-    if (state.generalTimerActive) {
-        if (currentMillis - timers.generalTimerStartTime >= WIND_TIME_MS && state.windOn) {
-            state.windOn = false;
+// Single-character queries over Serial:
+//   m   memory report (static sizes, heap, stack high-water marks)
+//   s   frame stats (governor quality level, frame cost, overruns)
+//   t   event trace as Chrome trace JSON (only with TRACE_EVENTS, Config.h)
+//   p   list the table profiles
+// Line commands, only acted on at the newline so a stray byte can't write flash:
+//   pN  store profile N (0-9) for the next boot (overrides the strap pin)
+//   px  clear the stored profile (the strap pin decides again)
+void handleSerialCommands() {
+    while (Serial.available() > 0) {
+        const int c = Serial.read();
+        if (profileCommand) {
+            if (c == '\n' || c == '\r') {
+                profileCommand = false;
+                if (profileArgument == 'x') {
+                    profileStore(0xFF);
+                    printProfiles();
+                } else if (profileArgument >= '0' && profileArgument <= '9') {
+                    if (!profileStore((uint8_t)(profileArgument - '0'))) Serial.println("No such profile");
+                    printProfiles();
+                }
+                continue;
+            }
+            // one argument character; anything else drops the command
+            if (profileArgument == 0 && ((c >= '0' && c <= '9') || c == 'x' || c == 'X')) {
+                profileArgument = c == 'X' ? 'x' : c;
+                continue;
+            }
+            profileCommand = false;
         }
-
-        if (currentMillis - timers.generalTimerStartTime >= RUN_TIME_MS) {
-            state.hydrogenStorageFull = false;
-            state.electricityTransportOn = false;
-            state.generalTimerActive = false;
-            state.buttonDisabled = false;
-            state.emptyPipe = false;
-            state.pipeEmpty = false;
-            resetAllVariables();
-            digitalWrite(BUTTON_LED_PIN, HIGH);
+        switch (c) {
+        case 'm':
+        case 'M':
+            memoryReportPrint(state, timers);
+            break;
+        case 's':
+        case 'S':
+            frameGovernorPrint(state.governor);
+            break;
+#if TRACE_EVENTS
+        case 't':
+        case 'T':
+            traceDump(state.trace);
+            break;
+#endif
+        case 'p':
+        case 'P':
+            printProfiles();
+            profileCommand = true;
+            profileArgument = 0;
+            break;
         }
-        return;
     }
+}
 
-    // Debounced button check
-    if (currentMillis - timers.previousButtonCheckMillis >= BUTTON_CHECK_INTERVAL) {
-        timers.previousButtonCheckMillis = currentMillis;
-
-        static uint32_t lastPressTime = 0;
-        const uint32_t debounceMs = 50;
-
-        if (digitalRead(BUTTON_PIN) == LOW && !state.buttonDisabled) {
-            if (currentMillis - lastPressTime < debounceMs) return;
-            lastPressTime = currentMillis;
+void printProfiles() {
+    const int stored = profileStored();
+    for (uint8_t i = 0; i < kProfileCount; ++i) {
+        Serial.printf("%c%c %u %-10s %3u logical, %3u physical LEDs\n",
+                      &kProfiles[i] == state.profile ? '*' : ' ', i == stored ? 'S' : ' ', i,
+                      kProfiles[i].name, kProfiles[i].logicalLeds, kProfiles[i].physicalLeds);
+    }
+    Serial.println("(* running, S stored for the next boot; pN + Enter stores N, px + Enter clears; reboot to switch)");
+}
 
-            digitalWrite(BUTTON_LED_PIN, LOW);
-            state.windOn = true;
-            state.buttonDisabled = true;
-            state.generalTimerActive = true;
-            timers.generalTimerStartTime = currentMillis;
+// Plays the prerendered attract loop while the table waits for the button.
+// Returns true while the clip owns the LEDs.
+bool updateIdleClip(SystemState &state) {
+#if IDLE_CLIP
+    if (kIdleClipPixels != state.profile->logicalLeds) return false;
+    if (!state.generalTimerActive) {
+        if (!state.idleClip.playing) {
+            clipPlayerStart(state.idleClip, kIdleClip, kIdleClipSize, true, millis());
         }
+        clipPlayerUpdate(state.idleClip, state.leds, 0, millis());
+        return true;
     }
+    if (state.idleClip.playing) {
+        // Button pressed: hand the LEDs back to the live effects
+        clipPlayerStop(state.idleClip);
+        fill_solid(state.leds, kMaxLogicalLeds, CRGB::Black);
+    }
+#else
+    (void)state;
+#endif
+    return false;
 }
-
-void resetAllVariables() {
-    // reset flags (state)
-    state.windOn = false;
-    state.solarOn = false;
-    state.electricityProductionOn = false;
-    state.electrolyserOn = false;
-    state.hydrogenTransportOn = false;
-    state.hydrogenProductionOn = false;
-    state.hydrogenStorageOn = false;
-    state.hydrogenStorageFull = false;
-    state.h2ConsumptionOn = false;
-    state.fabricationOn = false;
-    state.electricityTransportOn = false;
-    state.storageTransportOn = false;
-    state.storagePowerstationOn = false;
-    state.streetLightOn = false;
-    state.emptyPipe = false;
-    state.pipeEmpty = false;
-
-    // reset timers to now (avoid immediate re-trigger)
-    uint32_t now = millis();
-    timers.previousButtonCheckMillis = now;
-    timers.previousMillisWind = now;
-    timers.previousMillisSolar = now;
-    timers.previousMillisElectricityProduction = now;
-    timers.previousMillisElectrolyser = now;
-    timers.previousMillisHydrogenTransport = now;
-    timers.previousMillisHydrogenProduction = now;
-    timers.previousMillisHydrogenStorage = now;
-    timers.previousMillisHydrogenStorage2 = now;
-    timers.previousMillisH2Consumption = now;
-    timers.hydrogenStorageFullStartTime = now;
-    timers.previousMillisElectricityTransport = now;
-    timers.previousMillisStorageTransport = now;
-    timers.previousMillisStoragePowerstation = now;
-    timers.hydrogenStorageFullTimer = now;
-
-    // reset indices
-    state.windSegment = WIND_LED_START;
-    state.solarSegment = SOLAR_LED_END;
-    state.electricityProductionSegment = ELECTRICITY_PRODUCTION_LED_START;
-    state.hydrogenTransportSegment = HYDROGEN_TRANSPORT_LED_START;
-    state.hydrogenProductionSegment = HYDROGEN_PRODUCTION_LED_START;
-    state.hydrogenStorageSegment1 = HYDROGEN_STORAGE1_LED_START;
-    state.hydrogenStorageSegment2 = HYDROGEN_STORAGE2_LED_START;
-    state.h2ConsumptionSegment = HYDROGEN_CONSUMPTION_LED_START;
-    state.electricityTransportSegment = ELECTRICITY_TRANSPORT_LED_START;
-    state.storageTransportSegment = STORAGE_TRANSPORT_LED_START;
-    state.storagePowerstationSegment = STORAGE_POWERSTATION_LED_START;
-
-    // reset first-run flags
-    state.firstRunWind = true;
-    state.firstRunSolar = true;
-    state.firstRunElectricityProduction = true;
-    state.firstRunHydrogenProduction = true;
-    state.firstRunHydrogenTransport = true;
-    state.firstRunHydrogenStorage = true;
-    state.firstRunHydrogenStorage2 = true;
-    state.firstRunH2Consumption = true;
-    state.firstRunElectricityTransport = true;
-    state.firstRunStorageTransport = true;
-    state.firstRunStoragePowerstation = true;
-
-    // button/timer states
-    state.buttonDisabled = false;
-    timers.buttonDisableStartTime = 0;
-    timers.generalTimerStartTime = 0;
-    state.generalTimerActive = false;
-    state.storageTimerStarted = false;
-}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "../../include/model/HydrogenModel.h"
+#include "../../include/SystemState.h"
+
+// Step length in seconds
+static const q16_t kStepSeconds = (q16_t)(((int64_t)MODEL_STEP_MS << 16) / 1000);
+
+// Fraction of the remaining gap closed per step for a first-order lag with time constant tauMs
+static q16_t lagFactor(uint32_t tauMs) {
+    if (tauMs <= MODEL_STEP_MS) return Q16_ONE;
+    return (q16_t)(((int64_t)MODEL_STEP_MS << 16) / tauMs);
+}
+
+static void modelStep(HydrogenModel &m, const SystemState &state) {
+    // Wind turbine ramps towards rated power while running and spins down otherwise
+    q16_t windTarget = state.windOn ? Q16(WIND_RATED_KW) : 0;
+    m.windPowerKw += q16Mul(windTarget - m.windPowerKw, lagFactor(WIND_RAMP_MS));
+
+    // Electrolyser takes what the wind delivers, up to its rating
+    if (state.electrolyserOn) {
+        q16_t available = m.windPowerKw < Q16(ELECTROLYSER_RATED_KW) ? m.windPowerKw : Q16(ELECTROLYSER_RATED_KW);
+        m.electrolyserKw = available;
+    } else {
+        m.electrolyserKw = 0;
+    }
+
+    // Production only reaches the pipe once the hydrogen stage is running
+    m.productionGps = state.hydrogenProductionOn ? q16Mul(m.electrolyserKw, Q16(H2_GPS_PER_KW)) : 0;
+
+    // The factory draws first; whatever is left goes into storage
+    m.consumptionGps = 0;
+    if (state.h2ConsumptionOn) {
+        m.consumptionGps = m.productionGps < Q16(H2_CONSUMPTION_GPS) ? m.productionGps : Q16(H2_CONSUMPTION_GPS);
+    }
+    m.storageInflowGps = state.hydrogenStorageOn ? m.productionGps - m.consumptionGps : 0;
+    m.storageOutflowGps = (state.storageDraining && m.storageMassG > 0) ? Q16(STORAGE_DRAIN_GPS) : 0;
+
+    m.storageMassG += q16Mul(m.storageInflowGps - m.storageOutflowGps, kStepSeconds);
+    if (m.storageMassG < 0) m.storageMassG = 0;
+    if (m.storageMassG > Q16(STORAGE_CAPACITY_G)) m.storageMassG = Q16(STORAGE_CAPACITY_G);
+}
+
+void hydrogenModelReset(HydrogenModel &model, uint32_t now) {
+    model = HydrogenModel();
+    model.previousMillis = now;
+}
+
+void hydrogenModelUpdate(SystemState &state, uint32_t now) {
+    HydrogenModel &m = state.model;
+    m.accumulatorMs += now - m.previousMillis;
+    m.previousMillis = now;
+
+    // Drop backlog after a long stall rather than running a burst of steps
+    if (m.accumulatorMs > 10 * MODEL_STEP_MS) m.accumulatorMs = 10 * MODEL_STEP_MS;
+
+    while (m.accumulatorMs >= MODEL_STEP_MS) {
+        m.accumulatorMs -= MODEL_STEP_MS;
+        modelStep(m, state);
+    }
+}
+
+uint8_t hydrogenModelFlowSpeed(q16_t massFlowGps) {
+    if (massFlowGps <= 0) return 0;
+    // Rated production moves packets at HYDROGEN_FLOW_SPEED; keep a visible minimum
+    int32_t speed = (int32_t)(((int64_t)HYDROGEN_FLOW_SPEED * massFlowGps) / Q16(H2_RATED_GPS));
+    if (speed < 4) speed = 4;
+    if (speed > 255) speed = 255;
+    return (uint8_t)speed;
+}
+
+uint8_t hydrogenModelFlowDensity(q16_t massFlowGps) {
+    if (massFlowGps <= 0) return 0;
+    int32_t density = (int32_t)(((int64_t)HYDROGEN_FLOW_DENSITY * massFlowGps) / Q16(H2_RATED_GPS));
+    if (density < 8) density = 8;
+    if (density > 255) density = 255;
+    return (uint8_t)density;
+}
+
+int hydrogenModelStorageFill(const HydrogenModel &model, int length) {
+    // Round up so any stored gas shows at least one LED
+    int64_t scaled = (int64_t)model.storageMassG * length;
+    int fill = (int)((scaled + Q16(STORAGE_CAPACITY_G) - 1) / Q16(STORAGE_CAPACITY_G));
+    return fill > length ? length : fill;
+}
+
+bool hydrogenModelStorageFull(const HydrogenModel &model) {
+    return model.storageMassG >= Q16(STORAGE_CAPACITY_G);
+}
@@ -0,0 +1,60 @@
+#include "../../include/ClipPlayer.h"
+#include "../../include/FrameCodec.h"
+
+static inline uint16_t readU16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+bool clipPlayerStart(ClipPlayer &player, const uint8_t *clip, uint32_t size, bool loop, uint32_t now) {
+    player = ClipPlayer();
+    if (!clip || size < CLIP_HEADER_BYTES) return false;
+    if (clip[0] != CLIP_MAGIC0 || clip[1] != CLIP_MAGIC1 || clip[2] != CLIP_MAGIC2 || clip[3] != CLIP_MAGIC3) return false;
+    if (clip[4] != CLIP_VERSION) return false;
+
+    player.clip = clip;
+    player.size = size;
+    player.pixels = readU16(clip + 6);
+    player.frameCount = readU16(clip + 8);
+    player.frameMs = readU16(clip + 10);
+    player.loop = loop;
+    player.playing = player.frameCount > 0;
+    // First frame is due immediately
+    player.previousMillis = now - player.frameMs;
+    return player.playing;
+}
+
+void clipPlayerStop(ClipPlayer &player) {
+    player.playing = false;
+}
+
+bool clipPlayerUpdate(ClipPlayer &player, CRGB *leds, int start, uint32_t now) {
+    if (!player.playing) return false;
+    if (now - player.previousMillis < player.frameMs) return false;
+    // Catch up by at most one frame: a late frame is shown late, not skipped
+    player.previousMillis = (now - player.previousMillis >= 2u * player.frameMs) ? now : player.previousMillis + player.frameMs;
+
+    uint8_t *pixels = reinterpret_cast<uint8_t *>(leds + start);
+    if (player.frame == 0) {
+        fill_solid(leds + start, player.pixels, CRGB::Black);
+    }
+
+    if (player.offset + 2 > player.size) {
+        player.playing = false;
+        return false;
+    }
+    const uint16_t length = readU16(player.clip + player.offset);
+    if (player.offset + 2 + length > player.size ||
+        !frameApplyOps(player.clip + player.offset + 2, length, pixels, player.pixels)) {
+        // Truncated or corrupt clip
+        player.playing = false;
+        return false;
+    }
+    player.offset += 2 + length;
+
+    if (++player.frame >= player.frameCount) {
+        player.frame = 0;
+        player.offset = CLIP_HEADER_BYTES;
+        player.playing = player.loop;
+    }
+    return true;
+}
@@ -0,0 +1,91 @@
+#include "../../include/DemoCycle.h"
+#include <Arduino.h>
+#include "../../include/effects/Effects.h"
+#include "../../include/model/HydrogenModel.h"
+#include "../../include/OutputStage.h"
+#include "../../include/FrameGovernor.h"
+
+void demoCycleBegin(SystemState &state, Timers &timers) {
+    state.hydrogenProductionFade = state.fades.acquire(FADE_DURATION_MS);
+    state.fabricationFire = state.fires.acquire();
+    state.hydrogenTransportFlow = state.flows.acquire();
+    state.hydrogenStorageFlow1 = state.flows.acquire();
+    state.hydrogenStorageFlow2 = state.flows.acquire();
+    state.h2ConsumptionFlow = state.flows.acquire();
+    digitalWrite(BUTTON_LED_PIN, HIGH);
+    resetAllVariables(state, timers);
+}
+
+void updateRelays(const SystemState &state) {
+    digitalWrite(WIND_TURBINE_RELAY_PIN, state.windOn ? HIGH : LOW);
+    digitalWrite(ELECTROLYSER_RELAY_PIN, state.electrolyserOn ? HIGH : LOW);
+}
+
+void checkButtonState(SystemState &state, Timers &timers) {
+    uint32_t currentMillis = millis();
+    // if general timer active handle timeouts
+    if (state.generalTimerActive) {
+        if (currentMillis - timers.generalTimerStartTime >= WIND_TIME_MS && state.windOn) {
+            state.windOn = false;
+        }
+
+        if (currentMillis - timers.generalTimerStartTime >= RUN_TIME_MS) {
+            state.hydrogenStorageFull = false;
+            state.electricityTransportOn = false;
+            state.generalTimerActive = false;
+            state.buttonDisabled = false;
+            state.emptyPipe = false;
+            state.pipeEmpty = false;
+            resetAllVariables(state, timers);
+            digitalWrite(BUTTON_LED_PIN, HIGH);
+        }
+        return;
+    }
+
+    // Debounced button check
+    if (currentMillis - timers.previousButtonCheckMillis >= BUTTON_CHECK_INTERVAL) {
+        timers.previousButtonCheckMillis = currentMillis;
+
+        const uint32_t debounceMs = 50;
+
+        if (digitalRead(BUTTON_PIN) == LOW && !state.buttonDisabled) {
+            if (currentMillis - timers.lastPressTime < debounceMs) return;
+            timers.lastPressTime = currentMillis;
+
+            digitalWrite(BUTTON_LED_PIN, LOW);
+            state.windOn = true;
+            state.buttonDisabled = true;
+            state.generalTimerActive = true;
+            timers.generalTimerStartTime = currentMillis;
+        }
+    }
+}
+
+void resetAllVariables(SystemState &state, Timers &timers) {
+    // every registered effect resets its own flags, cursors and timers
+    uint32_t now = millis();
+    resetSegments(state, timers, now);
+    hydrogenModelReset(state.model, now);
+
+    // button/timer states
+    timers.previousButtonCheckMillis = now;
+    state.buttonDisabled = false;
+    timers.buttonDisableStartTime = 0;
+    timers.generalTimerStartTime = 0;
+    state.generalTimerActive = false;
+}
+
+void demoCyclePass(SystemState &state, Timers &timers, DemoLedOwner ledOwner) {
+    // the whole pass is measured, including show(), for the frame governor
+    const uint32_t frameStart = micros();
+    checkButtonState(state, timers);
+    TRACE_OBSERVE(state, timers, "button");
+    hydrogenModelUpdate(state, millis());
+    TRACE_OBSERVE(state, timers, "model");
+    if (!ledOwner || !ledOwner(state)) {
+        updateSegments(state, timers);
+    }
+    updateRelays(state);
+    showFrame(state);
+    frameGovernorUpdate(state.governor, micros() - frameStart, millis());
+}
@@ -0,0 +1,228 @@
+#include "../../include/FrameCodec.h"
+#include <string.h>
+
+#define OP_SKIP 0x00
+#define OP_RUN 0x40
+#define OP_LITERAL 0x80
+#define OP_MAX_COUNT 64
+
+static void fletcherUpdate(uint16_t &a, uint16_t &b, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        a = (a + data[i]) % 255;
+        b = (b + a) % 255;
+    }
+}
+
+uint16_t frameChecksum(const uint8_t *data, size_t length) {
+    uint16_t a = 0, b = 0;
+    fletcherUpdate(a, b, data, length);
+    return (uint16_t)((b << 8) | a);
+}
+
+static inline bool samePixel(const uint8_t *a, const uint8_t *b) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+static const uint8_t kBlack[3] = { 0, 0, 0 };
+
+bool frameEncodeOps(const uint8_t *pixels, const uint8_t *prev, uint16_t count,
+                    uint8_t *out, size_t outCapacity, size_t *length) {
+    uint8_t *p = out;
+    uint8_t *limit = out + outCapacity;
+
+    uint16_t i = 0;
+    while (i < count) {
+        const uint8_t *base = prev ? prev + i * 3 : kBlack;
+
+        // Unchanged pixels
+        if (samePixel(pixels + i * 3, base)) {
+            uint16_t n = 1;
+            while (i + n < count && n < OP_MAX_COUNT && samePixel(pixels + (i + n) * 3, prev ? prev + (i + n) * 3 : kBlack)) ++n;
+            // A trailing skip carries no information
+            if (i + n == count) break;
+            if (p + 1 > limit) return false;
+            *p++ = OP_SKIP | (uint8_t)(n - 1);
+            i += n;
+            continue;
+        }
+
+        // Run of one colour
+        uint16_t n = 1;
+        while (i + n < count && n < OP_MAX_COUNT && samePixel(pixels + (i + n) * 3, pixels + i * 3)) ++n;
+        if (n >= 2) {
+            if (p + 4 > limit) return false;
+            *p++ = OP_RUN | (uint8_t)(n - 1);
+            memcpy(p, pixels + i * 3, 3);
+            p += 3;
+            i += n;
+            continue;
+        }
+
+        // Literals until an unchanged pixel or the start of a run
+        n = 1;
+        while (i + n < count && n < OP_MAX_COUNT) {
+            const uint8_t *px = pixels + (i + n) * 3;
+            if (samePixel(px, prev ? prev + (i + n) * 3 : kBlack)) break;
+            if (i + n + 1 < count && samePixel(px, px + 3)) break;
+            ++n;
+        }
+        if (p + 1 + n * 3 > limit) return false;
+        *p++ = OP_LITERAL | (uint8_t)(n - 1);
+        memcpy(p, pixels + i * 3, n * 3);
+        p += n * 3;
+        i += n;
+    }
+
+    *length = (size_t)(p - out);
+    return true;
+}
+
+bool frameApplyOps(const uint8_t *ops, size_t length, uint8_t *pixels, uint16_t count) {
+    uint16_t i = 0;
+    size_t k = 0;
+    while (k < length) {
+        uint8_t op = ops[k++];
+        uint16_t len = (uint16_t)(op & 0x3F) + 1;
+        if (i + len > count) return false;
+        switch (op & 0xC0) {
+        case OP_SKIP:
+            break;
+        case OP_RUN:
+            if (k + 3 > length) return false;
+            for (uint16_t j = 0; j < len; ++j) memcpy(pixels + (i + j) * 3, ops + k, 3);
+            k += 3;
+            break;
+        case OP_LITERAL:
+            if (k + len * 3 > length) return false;
+            memcpy(pixels + i * 3, ops + k, len * 3);
+            k += len * 3;
+            break;
+        default:
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+size_t frameEncode(const uint8_t *pixels, const uint8_t *prev, uint16_t count, uint8_t seq,
+                   uint8_t *out, size_t outCapacity) {
+    if (outCapacity < FRAME_HEADER_BYTES + FRAME_TRAILER_BYTES) return 0;
+
+    size_t payloadLength = 0;
+    if (!frameEncodeOps(pixels, prev, count, out + FRAME_HEADER_BYTES,
+                        outCapacity - FRAME_HEADER_BYTES - FRAME_TRAILER_BYTES, &payloadLength)) {
+        return 0;
+    }
+
+    out[0] = FRAME_SYNC0;
+    out[1] = FRAME_SYNC1;
+    out[2] = prev ? FRAME_TYPE_DELTA : FRAME_TYPE_KEY;
+    out[3] = seq;
+    out[4] = (uint8_t)(count & 0xFF);
+    out[5] = (uint8_t)(count >> 8);
+    out[6] = (uint8_t)(payloadLength & 0xFF);
+    out[7] = (uint8_t)(payloadLength >> 8);
+
+    uint8_t *p = out + FRAME_HEADER_BYTES + payloadLength;
+    uint16_t sum = frameChecksum(out + 2, FRAME_HEADER_BYTES - 2 + payloadLength);
+    *p++ = (uint8_t)(sum & 0xFF);
+    *p++ = (uint8_t)(sum >> 8);
+    return (size_t)(p - out);
+}
+
+// ---- Decoder
+
+enum {
+    PHASE_SYNC0,
+    PHASE_SYNC1,
+    PHASE_HEADER,
+    PHASE_PAYLOAD,
+    PHASE_TRAILER
+};
+
+FrameStreamDecoder::FrameStreamDecoder(uint8_t *pixels, uint16_t capacity, uint8_t *packetBuffer)
+    : pixels(pixels), capacity(capacity), count(0), payload(packetBuffer), payloadLength(0), received(0),
+      phase(PHASE_SYNC0), expectedSeq(0), synced(false), frames(0), dropped(0), lastPacketBytes(0) {
+    memset(pixels, 0, (size_t)capacity * 3);
+}
+
+bool FrameStreamDecoder::feed(uint8_t byte) {
+    switch (phase) {
+    case PHASE_SYNC0:
+        if (byte == FRAME_SYNC0) phase = PHASE_SYNC1;
+        return false;
+    case PHASE_SYNC1:
+        phase = byte == FRAME_SYNC1 ? PHASE_HEADER : (byte == FRAME_SYNC0 ? PHASE_SYNC1 : PHASE_SYNC0);
+        received = 2;
+        return false;
+    case PHASE_HEADER:
+        header[received++] = byte;
+        if (received == FRAME_HEADER_BYTES) {
+            payloadLength = (uint16_t)(header[6] | (header[7] << 8));
+            uint16_t n = (uint16_t)(header[4] | (header[5] << 8));
+            bool typeOk = header[2] == FRAME_TYPE_KEY || header[2] == FRAME_TYPE_DELTA;
+            if (!typeOk || n > capacity || payloadLength > FRAME_MAX_PAYLOAD(capacity)) {
+                ++dropped;
+                phase = PHASE_SYNC0;
+                return false;
+            }
+            received = 0;
+            phase = PHASE_PAYLOAD;
+            if (payloadLength == 0) phase = PHASE_TRAILER;
+        }
+        return false;
+    case PHASE_PAYLOAD:
+        payload[received++] = byte;
+        if (received == payloadLength) phase = PHASE_TRAILER;
+        return false;
+    case PHASE_TRAILER:
+        payload[received++] = byte;
+        if (received < payloadLength + FRAME_TRAILER_BYTES) return false;
+        phase = PHASE_SYNC0;
+        {
+            uint16_t expected = (uint16_t)(payload[payloadLength] | (payload[payloadLength + 1] << 8));
+            // checksum covers the header after the sync bytes plus the payload
+            uint16_t a = 0, b = 0;
+            fletcherUpdate(a, b, header + 2, FRAME_HEADER_BYTES - 2);
+            fletcherUpdate(a, b, payload, payloadLength);
+            if ((uint16_t)((b << 8) | a) != expected) {
+                ++dropped;
+                return false;
+            }
+        }
+        return applyPayload();
+    }
+    return false;
+}
+
+bool FrameStreamDecoder::applyPayload() {
+    const bool key = header[2] == FRAME_TYPE_KEY;
+    const uint8_t seq = header[3];
+    const uint16_t n = (uint16_t)(header[4] | (header[5] << 8));
+
+    if (!key && (!synced || seq != expectedSeq || n != count)) {
+        // Missed a packet: the base frame is unknown until the next keyframe
+        synced = false;
+        ++dropped;
+        return false;
+    }
+
+    if (key) {
+        count = n;
+        memset(pixels, 0, (size_t)count * 3);
+    }
+
+    // A malformed payload leaves the frame undefined until the next keyframe
+    if (!frameApplyOps(payload, payloadLength, pixels, count)) {
+        synced = false;
+        ++dropped;
+        return false;
+    }
+
+    synced = true;
+    expectedSeq = (uint8_t)(seq + 1);
+    lastPacketBytes = FRAME_HEADER_BYTES + payloadLength + FRAME_TRAILER_BYTES;
+    ++frames;
+    return true;
+}
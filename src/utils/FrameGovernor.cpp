@@ -0,0 +1,54 @@
+#include "../../include/FrameGovernor.h"
+#include <Arduino.h>
+
+const char *frameGovernorLevelName(uint8_t level) {
+    switch (level) {
+    case QUALITY_FULL: return "full";
+    case QUALITY_REDUCED: return "reduced";
+    case QUALITY_MINIMAL: return "minimal";
+    default: return "?";
+    }
+}
+
+void frameGovernorUpdate(FrameGovernor &governor, uint32_t costUs, uint32_t now) {
+    // Start from the first sample instead of ramping up from zero
+    if (governor.frames == 0) {
+        governor.averageUs = costUs;
+        governor.lastChangeMillis = now;
+    } else {
+        governor.averageUs = governor.averageUs - governor.averageUs / 8 + costUs / 8;
+    }
+    ++governor.frames;
+    if (costUs > governor.worstUs) governor.worstUs = costUs;
+    if (costUs > GOVERNOR_BUDGET_US) ++governor.overruns;
+
+    // Hold each level for a while so a single slow frame doesn't flip it back and forth
+    const uint32_t held = now - governor.lastChangeMillis;
+    if (governor.averageUs > GOVERNOR_BUDGET_US) {
+        if (governor.level < QUALITY_MINIMAL && held >= GOVERNOR_HOLD_MS) {
+            ++governor.level;
+            ++governor.downgrades;
+            governor.lastChangeMillis = now;
+            Serial.printf("Quality %s (frame %u us)\n", frameGovernorLevelName(governor.level), (unsigned)governor.averageUs);
+        }
+    } else if (governor.averageUs * 100 > (uint32_t)GOVERNOR_BUDGET_US * GOVERNOR_RESTORE_PERCENT) {
+        // Not enough headroom yet: restart the restore wait
+        if (governor.level > QUALITY_FULL) governor.lastChangeMillis = now;
+    } else if (governor.level > QUALITY_FULL && held >= GOVERNOR_RESTORE_MS) {
+        --governor.level;
+        ++governor.upgrades;
+        governor.lastChangeMillis = now;
+        Serial.printf("Quality %s (frame %u us)\n", frameGovernorLevelName(governor.level), (unsigned)governor.averageUs);
+    }
+}
+
+void frameGovernorPrint(FrameGovernor &governor) {
+    Serial.println("---- frame governor");
+    Serial.printf("  level          %s (%u)\n", frameGovernorLevelName(governor.level), governor.level);
+    Serial.printf("  frame average  %u us of %u us budget\n", (unsigned)governor.averageUs, (unsigned)GOVERNOR_BUDGET_US);
+    Serial.printf("  worst frame    %u us\n", (unsigned)governor.worstUs);
+    Serial.printf("  overruns       %u of %u frames\n", (unsigned)governor.overruns, (unsigned)governor.frames);
+    Serial.printf("  level changes  %u down, %u up\n", (unsigned)governor.downgrades, (unsigned)governor.upgrades);
+    Serial.println("----");
+    governor.worstUs = 0;
+}
@@ -0,0 +1,34 @@
+#include "../../include/FrameMirror.h"
+#include <Arduino.h>
+
+void frameMirrorSend(FrameMirror &mirror, const CRGB *leds, uint16_t count) {
+    if (!mirror.enabled) return;
+
+    uint32_t currentMillis = millis();
+    if (currentMillis - mirror.previousMillis < FRAME_MIRROR_INTERVAL_MS) return;
+    mirror.previousMillis = currentMillis;
+
+    const bool key = mirror.packetsSinceKey >= FRAME_MIRROR_KEYFRAME_EVERY;
+    const uint8_t *pixels = reinterpret_cast<const uint8_t *>(leds);
+    const uint8_t *base = key ? nullptr : reinterpret_cast<const uint8_t *>(mirror.sent);
+
+    size_t length = frameEncode(pixels, base, count, mirror.seq, mirror.packet, sizeof(mirror.packet));
+    if (length == 0) return;
+
+    // Nothing changed: don't spend UART bandwidth on an empty delta
+    if (!key && length == FRAME_HEADER_BYTES + FRAME_TRAILER_BYTES) return;
+
+    // Keyframes go out even if they have to wait for the UART
+    if (!key && Serial.availableForWrite() < (int)length) {
+        // a skipped delta still counts towards the next keyframe
+        ++mirror.framesSkipped;
+        ++mirror.packetsSinceKey;
+        return;
+    }
+
+    Serial.write(mirror.packet, length);
+    memcpy(mirror.sent, leds, count * sizeof(CRGB));
+    ++mirror.seq;
+    ++mirror.framesSent;
+    mirror.packetsSinceKey = key ? 1 : mirror.packetsSinceKey + 1;
+}
@@ -0,0 +1,94 @@
+#include "../../include/MemoryReport.h"
+#include <Arduino.h>
+
+static void printLine(const char *name, size_t bytes) {
+    Serial.printf("  %-24s %7u B\n", name, (unsigned)bytes);
+}
+
+static void printStatic(const SystemState &state, const Timers &timers) {
+    Serial.printf("profile: %s (%u logical / %u physical LEDs)\n", state.profile->name,
+                  state.profile->logicalLeds, state.profile->physicalLeds);
+    Serial.println("static:");
+    printLine("SystemState", sizeof(SystemState));
+    printLine("  leds (logical)", sizeof(state.leds));
+    printLine("  output stage", sizeof(state.output));
+    printLine("    frame (physical)", sizeof(state.output.frame));
+    printLine("    LUTs", sizeof(state.output.lut));
+    printLine("  hydrogen model", sizeof(state.model));
+    printLine("  fade pool", sizeof(state.fades));
+    printLine("  fire pool", sizeof(state.fires));
+    printLine("  gas flow pool", sizeof(state.flows));
+#if FRAME_MIRROR
+    printLine("  frame mirror", sizeof(state.mirror));
+#endif
+#if IDLE_CLIP
+    printLine("  idle clip player", sizeof(state.idleClip));
+#endif
+#if TRACE_EVENTS
+    printLine("  event trace", sizeof(state.trace));
+#endif
+    printLine("Timers", sizeof(Timers));
+    Serial.printf("  pools in use: fades %u/%u, fires %u/%u, flows %u/%u\n",
+                  state.fades.inUse(), state.fades.capacity(),
+                  state.fires.inUse(), state.fires.capacity(),
+                  state.flows.inUse(), state.flows.capacity());
+}
+
+#if defined(ESP32)
+
+#ifndef CONFIG_ARDUINO_LOOP_STACK_SIZE
+#define CONFIG_ARDUINO_LOOP_STACK_SIZE 8192
+#endif
+
+static void printTaskStack(const char *name, TaskHandle_t task, unsigned size) {
+    if (!task) return;
+    // ESP-IDF reports the high-water mark in bytes
+    unsigned freeBytes = (unsigned)uxTaskGetStackHighWaterMark(task);
+    if (size) {
+        Serial.printf("  %-24s %7u B min free of %u\n", name, freeBytes, size);
+    } else {
+        Serial.printf("  %-24s %7u B min free\n", name, freeBytes);
+    }
+}
+
+static void printHeapAndStacks() {
+    Serial.println("heap:");
+    printLine("size", ESP.getHeapSize());
+    printLine("free", ESP.getFreeHeap());
+    printLine("min free (ever)", ESP.getMinFreeHeap());
+    printLine("largest block", ESP.getMaxAllocHeap());
+
+    Serial.println("stack:");
+    printTaskStack("loop task", xTaskGetCurrentTaskHandle(), CONFIG_ARDUINO_LOOP_STACK_SIZE);
+    printTaskStack("idle cpu0", xTaskGetIdleTaskHandleForCPU(0), 0);
+#if portNUM_PROCESSORS > 1
+    printTaskStack("idle cpu1", xTaskGetIdleTaskHandleForCPU(1), 0);
+#endif
+}
+
+#else
+
+static void printHeapAndStacks() {
+    const HostHeapStats heap = hostHeapStats();
+    Serial.println("heap (host tracking allocator):");
+    printLine("in use", heap.inUse);
+    printLine("peak", heap.peak);
+    Serial.printf("  %-24s %7u / %u\n", "allocations / frees", (unsigned)heap.allocations, (unsigned)heap.frees);
+
+    Serial.println("stack (host main thread):");
+    const size_t used = hostStackUsed();
+    if (used) {
+        printLine("deepest use", used);
+    } else {
+        Serial.println("  not measured (call hostStackPaint() first)");
+    }
+}
+
+#endif
+
+void memoryReportPrint(const SystemState &state, const Timers &timers) {
+    Serial.println("---- memory report");
+    printStatic(state, timers);
+    printHeapAndStacks();
+    Serial.println("----");
+}
@@ -0,0 +1,127 @@
+#include "../../include/OutputStage.h"
+#include "../../include/SystemState.h"
+#include <math.h>
+#include <string.h>
+
+static const OutputZone kDefaultZones[] = OUTPUT_ZONE_DEFAULTS;
+
+void outputStageInit(OutputStage &stage, const ProfileOps &profile) {
+    stage.physicalLeds = profile.physicalLeds;
+    stage.zoneCount = 0;
+    for (unsigned i = 0; i < sizeof(kDefaultZones) / sizeof(kDefaultZones[0]) && i < OUTPUT_MAX_ZONES; ++i) {
+        stage.zones[stage.zoneCount++] = kDefaultZones[i];
+    }
+    fill_solid(stage.frame, kMaxPhysicalLeds, CRGB::Black);
+    outputStageRebuild(stage);
+}
+
+void outputStageSetGamma(OutputStage &stage, uint16_t gammaX100) {
+    if (gammaX100 == 0) gammaX100 = 100;
+    if (gammaX100 != stage.gammaX100) {
+        stage.gammaX100 = gammaX100;
+        stage.dirty = true;
+    }
+}
+
+void outputStageSetBrightness(OutputStage &stage, uint8_t brightness) {
+    if (brightness != stage.brightness) {
+        stage.brightness = brightness;
+        stage.dirty = true;
+    }
+}
+
+bool outputStageSetZone(OutputStage &stage, uint8_t zone, int start, int end, CRGB white) {
+    if (zone >= OUTPUT_MAX_ZONES || zone > stage.zoneCount) return false;
+    OutputZone z = { start, end, white.r, white.g, white.b };
+    stage.zones[zone] = z;
+    if (zone == stage.zoneCount) ++stage.zoneCount;
+    stage.dirty = true;
+    return true;
+}
+
+void outputStageRebuild(OutputStage &stage) {
+    // Without any zone everything falls back to a neutral white point
+    if (stage.zoneCount == 0) {
+        OutputZone all = { 0, stage.physicalLeds - 1, 255, 255, 255 };
+        stage.zones[stage.zoneCount++] = all;
+    }
+
+    // Shared gamma curve (0..65535) so the per-zone tables only need a multiply;
+    // on the stack, rebuilds only happen at boot and when a setting changes
+    uint16_t curve[256];
+    const float gamma = stage.gammaX100 / 100.0f;
+    for (int v = 0; v < 256; ++v) {
+        curve[v] = (uint16_t)(powf(v / 255.0f, gamma) * 65535.0f + 0.5f);
+    }
+
+    for (uint8_t z = 0; z < stage.zoneCount; ++z) {
+        const uint8_t white[3] = { stage.zones[z].whiteR, stage.zones[z].whiteG, stage.zones[z].whiteB };
+        for (int c = 0; c < 3; ++c) {
+            // white point and brightness as one 0..65025 scale factor
+            const uint64_t scale = (uint64_t)white[c] * stage.brightness;
+            const uint64_t divisor = 65535ULL * 255ULL;
+            for (int v = 0; v < 256; ++v) {
+                uint32_t out = (uint32_t)((curve[v] * scale + divisor / 2) / divisor);
+                stage.lut[z][c][v] = out > 255 ? 255 : (uint8_t)out;
+            }
+        }
+    }
+
+    // LEDs outside every zone use zone 0; later zones win where zones overlap
+    for (int i = 0; i < kMaxPhysicalLeds; ++i) stage.zoneOf[i] = 0;
+    for (uint8_t z = 0; z < stage.zoneCount; ++z) {
+        int start = stage.zones[z].start < 0 ? 0 : stage.zones[z].start;
+        int end = stage.zones[z].end >= kMaxPhysicalLeds ? kMaxPhysicalLeds - 1 : stage.zones[z].end;
+        for (int i = start; i <= end; ++i) stage.zoneOf[i] = z;
+    }
+
+    stage.dirty = false;
+}
+
+template <typename P>
+void outputStageApplyFor(OutputStage &stage, const CRGB *leds) {
+    if (stage.dirty) outputStageRebuild(stage);
+
+    // Unmapped physical pixels are never written and stay black
+    static constexpr uint8_t kRunCount = sizeof(P::runs) / sizeof(P::runs[0]);
+    for (uint8_t r = 0; r < kRunCount; ++r) {
+        const TopologyRun &run = P::runs[r];
+        const CRGB *src = leds + run.logicalStart;
+        CRGB *dst = stage.frame + run.physicalStart;
+        const uint8_t *zone = stage.zoneOf + run.physicalStart;
+        for (uint16_t i = 0; i < run.length; ++i) {
+            const uint8_t (*lut)[256] = stage.lut[zone[i]];
+            dst[i].r = lut[0][src[i].r];
+            dst[i].g = lut[1][src[i].g];
+            dst[i].b = lut[2][src[i].b];
+        }
+    }
+}
+
+#define PROFILE_INSTANTIATE_APPLY(P) template void outputStageApplyFor<P>(OutputStage &, const CRGB *);
+PROFILE_LIST(PROFILE_INSTANTIATE_APPLY)
+
+void showFrame(SystemState &state) {
+    OutputStage &stage = state.output;
+    const size_t bytes = state.profile->logicalLeds * sizeof(CRGB);
+    bool unchanged = false;
+    if (state.governor.level >= QUALITY_MINIMAL) {
+        // Over budget: a frame identical to the last one sent is neither corrected nor clocked out
+        unchanged = stage.lastInputValid && !stage.dirty && memcmp(stage.lastInput, state.leds, bytes) == 0;
+        if (!unchanged) {
+            memcpy(stage.lastInput, state.leds, bytes);
+            stage.lastInputValid = true;
+        }
+    } else {
+        stage.lastInputValid = false;
+    }
+    if (!unchanged) {
+        state.profile->apply(stage, state.leds);
+        TRACE_SPAN_BEGIN(showStart);
+        FastLED.show();
+        TRACE_SPAN_END(state, showStart, "show");
+    }
+#if FRAME_MIRROR
+    frameMirrorSend(state.mirror, state.leds, state.profile->logicalLeds);
+#endif
+}
@@ -0,0 +1,60 @@
+#include "../../include/Profiles.h"
+#include "../../include/effects/Effects.h"
+#include "../../include/OutputStage.h"
+#include <Arduino.h>
+#include <Preferences.h>
+
+// Storage for the run tables (the effects and the output stage take their address)
+#define PROFILE_DEFINE_RUNS(P) constexpr TopologyRun P::runs[];
+PROFILE_LIST(PROFILE_DEFINE_RUNS)
+
+// Every profile has to fit its strip, its logical buffer, the fire effect and the gas flows
+#define PROFILE_CHECK(P)                                                                                                          \
+    static_assert(topologyPhysicalLeds(P::runs) <= P::stripLeds, #P ": run table is longer than the strip");                      \
+    static_assert(topologyLogicalInRange(P::runs, P::logicalLeds), #P ": run table reads past the logical LEDs");                 \
+    static_assert(P::fabricationEnd - P::fabricationStart + 1 <= FIRE_MAX_LEDS, #P ": fabrication is longer than FIRE_MAX_LEDS"); \
+    static_assert(P::hydrogenTransportEnd - P::hydrogenTransportStart + 1 <= GAS_FLOW_MAX_LENGTH &&                               \
+                  P::hydrogenStorage1End - P::hydrogenStorage1Start + 1 <= GAS_FLOW_MAX_LENGTH &&                                 \
+                  P::hydrogenStorage2End - P::hydrogenStorage2Start + 1 <= GAS_FLOW_MAX_LENGTH &&                                 \
+                  P::hydrogenConsumptionEnd - P::hydrogenConsumptionStart + 1 <= GAS_FLOW_MAX_LENGTH,                             \
+                  #P ": a gas flow segment is longer than GAS_FLOW_MAX_LENGTH");
+PROFILE_LIST(PROFILE_CHECK)
+static_assert(ProfileStandard::hydrogenTransportMid >= ProfileStandard::hydrogenTransportStart &&
+                  ProfileStandard::hydrogenTransportMid <= ProfileStandard::hydrogenTransportEnd,
+              "HYDROGEN_TRANSPORT_LED_MID must lie inside the hydrogen transport segment");
+
+#define PROFILE_OPS(P)                                                                                  \
+    { P::name(), &updateSegmentsFor<P>, &resetSegmentsFor<P>, &outputStageApplyFor<P>, P::runs,         \
+      (uint8_t)(sizeof(P::runs) / sizeof(P::runs[0])), (uint16_t)P::logicalLeds,                         \
+      (uint16_t)topologyPhysicalLeds(P::runs) },
+const ProfileOps kProfiles[] = { PROFILE_LIST(PROFILE_OPS) };
+const uint8_t kProfileCount = sizeof(kProfiles) / sizeof(kProfiles[0]);
+
+static const char *kPrefsNamespace = "hydrogen";
+static const char *kPrefsKey = "profile";
+
+int profileStored() {
+    Preferences prefs;
+    if (!prefs.begin(kPrefsNamespace, true)) return -1;
+    const uint8_t index = prefs.getUChar(kPrefsKey, 0xFF);
+    prefs.end();
+    return index < kProfileCount ? index : -1;
+}
+
+bool profileStore(uint8_t index) {
+    if (index >= kProfileCount && index != 0xFF) return false;
+    Preferences prefs;
+    if (!prefs.begin(kPrefsNamespace, false)) return false;
+    const bool ok = index == 0xFF ? prefs.remove(kPrefsKey) : prefs.putUChar(kPrefsKey, index) == 1;
+    prefs.end();
+    return ok;
+}
+
+const ProfileOps &profileSelect() {
+    const int stored = profileStored();
+    if (stored >= 0) return kProfiles[stored];
+
+    pinMode(PROFILE_STRAP_PIN, INPUT_PULLUP);
+    const uint8_t strapped = digitalRead(PROFILE_STRAP_PIN) == LOW ? 1 : 0;
+    return kProfiles[strapped < kProfileCount ? strapped : 0];
+}
@@ -0,0 +1,233 @@
+#include "../../include/Trace.h"
+
+#if TRACE_EVENTS
+#include <Arduino.h>
+#include <stdarg.h>
+#include "../../include/SystemState.h"
+
+// Stage flags, one track each in the viewer
+struct TraceStage {
+    bool SystemState::*flag;
+    const char *name;
+};
+
+static const TraceStage kStages[] = {
+    { &SystemState::generalTimerActive, "run" },
+    { &SystemState::windOn, "wind" },
+    { &SystemState::solarOn, "solar" },
+    { &SystemState::electricityProductionOn, "electricity production" },
+    { &SystemState::electrolyserOn, "electrolyser" },
+    { &SystemState::hydrogenProductionOn, "hydrogen production" },
+    { &SystemState::hydrogenTransportOn, "hydrogen transport" },
+    { &SystemState::hydrogenStorageOn, "hydrogen storage" },
+    { &SystemState::hydrogenStorageFull, "storage full" },
+    { &SystemState::storageDraining, "storage draining" },
+    { &SystemState::h2ConsumptionOn, "h2 consumption" },
+    { &SystemState::fabricationOn, "fabrication" },
+    { &SystemState::electricityTransportOn, "electricity transport" },
+    { &SystemState::storageTransportOn, "storage transport" },
+    { &SystemState::storagePowerstationOn, "storage powerstation" },
+    { &SystemState::streetLightOn, "street light" },
+    { &SystemState::emptyPipe, "empty pipe" },
+    { &SystemState::pipeEmpty, "pipe empty" },
+};
+static const uint8_t kStageCount = sizeof(kStages) / sizeof(kStages[0]);
+static_assert(sizeof(kStages) / sizeof(kStages[0]) <= 32, "stage flags are kept in a uint32_t");
+
+// Coroutine sleeps (Coroutine.h); the run timer follows them
+struct TraceTimer {
+    Coroutine SystemState::*task;
+    const char *name;
+};
+
+static const TraceTimer kTimers[] = {
+    { &SystemState::windTask, "wind task" },
+    { &SystemState::electricityProductionTask, "electricity production task" },
+    { &SystemState::electrolyserTask, "electrolyser task" },
+    { &SystemState::storageDrainTask, "storage drain task" },
+    { &SystemState::storageTransportTask, "storage transport task" },
+    { &SystemState::electricityTransportTask, "electricity transport task" },
+};
+static const uint8_t kRunTimer = sizeof(kTimers) / sizeof(kTimers[0]);
+static_assert(sizeof(kTimers) / sizeof(kTimers[0]) < sizeof(Trace().timerWake) / sizeof(uint32_t),
+              "one timerWake slot per coroutine plus the run timer");
+
+// Viewer tracks
+static const int kShowTrack = 1;
+static const int kStageTrack = 10;
+static const int kTimerTrack = 50;
+
+template <uint16_t N>
+static void traceRecord(TraceRing<N> &ring, uint8_t kind, uint8_t id, const char *source, uint32_t us, uint32_t arg) {
+    TraceEvent &e = ring.events[ring.next];
+    e.us = us;
+    e.arg = arg;
+    e.source = source;
+    e.kind = kind;
+    e.id = id;
+    ring.next = (uint16_t)((ring.next + 1) % N);
+    if (ring.count < N) {
+        ++ring.count;
+    } else {
+        ++ring.overwritten;
+    }
+}
+
+// k-th oldest event in the ring
+template <uint16_t N>
+static const TraceEvent &traceAt(const TraceRing<N> &ring, uint16_t k) {
+    return ring.events[(ring.next + N - ring.count + k) % N];
+}
+
+#if TRACE_EVENTS & TRACE_TIMERS
+// A timer starts when it gets armed, or re-armed with another wake time
+static void observeTimer(Trace &trace, uint8_t id, bool armed, uint32_t wakeAt, uint32_t now, const char *source) {
+    const uint8_t bit = (uint8_t)(1u << id);
+    if (armed && (!(trace.timersArmed & bit) || trace.timerWake[id] != wakeAt)) {
+        traceRecord(trace.events, TRACE_TIMER_START, id, source, micros(), wakeAt - now);
+        trace.timerWake[id] = wakeAt;
+    }
+    trace.timersArmed = armed ? (uint8_t)(trace.timersArmed | bit) : (uint8_t)(trace.timersArmed & ~bit);
+}
+#endif
+
+void traceObserve(Trace &trace, const SystemState &state, const Timers &timers, const char *source) {
+#if TRACE_EVENTS & TRACE_STAGES
+    uint32_t stages = 0;
+    for (uint8_t i = 0; i < kStageCount; ++i) {
+        if (state.*kStages[i].flag) stages |= 1u << i;
+    }
+    const uint32_t changed = stages ^ trace.stages;
+    if (changed) {
+        const uint32_t now = micros();
+        for (uint8_t i = 0; i < kStageCount; ++i) {
+            if (changed & (1u << i)) traceRecord(trace.stageEvents, stages & (1u << i) ? TRACE_STAGE_ON : TRACE_STAGE_OFF, i, source, now, 0);
+        }
+        trace.stages = stages;
+    }
+#endif
+#if TRACE_EVENTS & TRACE_TIMERS
+    const uint32_t now = millis();
+    for (uint8_t i = 0; i < kRunTimer; ++i) {
+        const Coroutine &co = state.*kTimers[i].task;
+        observeTimer(trace, i, co.sleeping, co.wakeAt, now, source);
+    }
+    observeTimer(trace, kRunTimer, state.generalTimerActive, timers.generalTimerStartTime + RUN_TIME_MS, now, source);
+#else
+    (void)timers;
+#endif
+}
+
+void traceSpan(Trace &trace, const char *name, uint32_t startUs) {
+    traceRecord(trace.events, TRACE_SPAN, 0, name, startUs, micros() - startUs);
+}
+
+// ---- Chrome "Trace Event Format" JSON: B/E slices per stage, X slices for timers and spans
+
+struct JsonOut {
+    TraceWriter write;
+    void *context;
+    bool first;
+};
+
+static void jsonItem(JsonOut &out, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void jsonItem(JsonOut &out, const char *format, ...) {
+    char line[200];
+    line[0] = out.first ? ' ' : ',';
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line + 1, sizeof(line) - 2, format, args);
+    va_end(args);
+    strcat(line, "\n");
+    out.write(out.context, line);
+    out.first = false;
+}
+
+static void jsonTrack(JsonOut &out, int track, const char *prefix, const char *name) {
+    jsonItem(out, "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"%s%s\"}}", track, prefix, name);
+    jsonItem(out, "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%d}}", track, track);
+}
+
+// Microseconds as decimal text without 64-bit printf support
+static const char *formatUs(char *buf, size_t size, uint64_t us) {
+    const unsigned long seconds = (unsigned long)(us / 1000000u);
+    const unsigned long rest = (unsigned long)(us % 1000000u);
+    if (seconds) {
+        snprintf(buf, size, "%lu%06lu", seconds, rest);
+    } else {
+        snprintf(buf, size, "%lu", rest);
+    }
+    return buf;
+}
+
+void traceWriteJson(const Trace &trace, TraceWriter write, void *context) {
+    JsonOut out = { write, context, true };
+    write(context, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    jsonItem(out, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"hydrogen (%lu stage, %lu timer/show() events overwritten)\"}}",
+             (unsigned long)trace.stageEvents.overwritten, (unsigned long)trace.events.overwritten);
+    jsonTrack(out, kShowTrack, "", "show()");
+    for (uint8_t i = 0; i < kStageCount; ++i) jsonTrack(out, kStageTrack + i, "stage ", kStages[i].name);
+    for (uint8_t i = 0; i < kRunTimer; ++i) jsonTrack(out, kTimerTrack + i, "", kTimers[i].name);
+    jsonTrack(out, kTimerTrack + kRunTimer, "", "run timer");
+
+    // Both rings merged, oldest first. micros() wraps every 71 minutes, so
+    // events are ordered by their signed difference and timestamps are summed
+    // from the differences between neighbouring events (0 = oldest event)
+    const TraceRing<TRACE_STAGE_CAPACITY> &stageRing = trace.stageEvents;
+    const TraceRing<TRACE_CAPACITY> &ring = trace.events;
+    uint16_t s = 0;
+    uint16_t k = 0;
+    uint64_t ts = 0;
+    uint32_t previousUs = 0;
+    bool firstEvent = true;
+    uint32_t stagesSeen = 0;
+    char tsText[24];
+    while (s < stageRing.count || k < ring.count) {
+        const bool fromStages = k >= ring.count ||
+                                (s < stageRing.count && (int32_t)(traceAt(stageRing, s).us - traceAt(ring, k).us) <= 0);
+        const TraceEvent &e = fromStages ? traceAt(stageRing, s++) : traceAt(ring, k++);
+        if (firstEvent) previousUs = e.us;
+        firstEvent = false;
+        ts += e.us - previousUs;
+        previousUs = e.us;
+        formatUs(tsText, sizeof(tsText), ts);
+
+        if (e.kind == TRACE_STAGE_ON || e.kind == TRACE_STAGE_OFF) {
+            const uint32_t bit = 1u << e.id;
+            // Switched on before the oldest event: open its slice at the start
+            if (!(stagesSeen & bit) && e.kind == TRACE_STAGE_OFF) {
+                jsonItem(out, "{\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":0,\"name\":\"%s\",\"args\":{\"by\":\"(before the trace)\"}}",
+                         kStageTrack + e.id, kStages[e.id].name);
+            }
+            stagesSeen |= bit;
+            jsonItem(out, "{\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%s,\"name\":\"%s\",\"args\":{\"by\":\"%s\"}}",
+                     e.kind == TRACE_STAGE_ON ? "B" : "E", kStageTrack + e.id, tsText, kStages[e.id].name, e.source);
+        } else if (e.kind == TRACE_TIMER_START) {
+            // A timer re-armed or reset before it ran out ends where the next one starts
+            uint32_t durUs = e.arg * 1000u;
+            for (uint16_t j = k; j < ring.count; ++j) {
+                const TraceEvent &later = traceAt(ring, j);
+                if (later.kind != TRACE_TIMER_START || later.id != e.id) continue;
+                if (later.us - e.us < durUs) durUs = later.us - e.us;
+                break;
+            }
+            jsonItem(out, "{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%s,\"dur\":%lu,\"name\":\"%lu ms\",\"args\":{\"by\":\"%s\"}}",
+                     kTimerTrack + e.id, tsText, (unsigned long)durUs, (unsigned long)e.arg, e.source);
+        } else {
+            jsonItem(out, "{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%s,\"dur\":%lu,\"name\":\"%s\"}",
+                     kShowTrack, tsText, (unsigned long)e.arg, e.source);
+        }
+    }
+    write(context, "]}\n");
+}
+
+static void writeSerial(void *, const char *text) {
+    Serial.print(text);
+}
+
+void traceDump(const Trace &trace) {
+    traceWriteJson(trace, writeSerial, nullptr);
+}
+
+#endif
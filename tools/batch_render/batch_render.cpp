@@ -0,0 +1,350 @@
+// batch_render.cpp
+// Host tool: renders many look-and-feel variants of the firmware's animation
+// in parallel and writes one filmstrip image per variant, for design reviews
+// without reflashing.
+//
+// Each variant is a set of EffectLook settings (include/EffectLook.h):
+// stage colours, chaser step times and the fire's cooling/sparking. Every
+// variant runs the unmodified firmware (setup()/loop(), Effects.cpp, lib/)
+// on the host shim's virtual clock, one loop pass per millisecond, in a
+// forked worker process of its own. One worker per CPU core runs at a time.
+// A filmstrip is a binary PPM: one row per sampled frame (time runs
+// downwards), one --scale x --scale block per logical LED, with a dark
+// column between segments.
+//
+//   g++ -std=gnu++11 -O2 -Itools/host -Iinclude -Ilib/fadeLeds -Ilib/fireEffect -Ilib/gasFlow -Ilib/runningLed
+//       tools/batch_render/batch_render.cpp src/main.cpp src/Hardware.cpp src/effects/Effects.cpp src/model/*.cpp
+//       src/utils/*.cpp lib/*/*.cpp tools/host/HostArduino.cpp tools/host/HostFastLED.cpp -o batch_render
+//
+//   batch_render variants.txt                        every variant in the file into ./render
+//   batch_render --seconds 30 --frame-ms 100 -o out variants.txt
+//   batch_render --set "fire cooling=30,55,80 sparking=60,120,200"   sweep without a file (9 variants)
+//
+// Variant file: one variant per line, "name key=value ...", '#' starts a
+// comment. A value list separated by commas sweeps it: the line expands to
+// every combination, with the values appended to the name. Keys:
+//   wind, production, storage, consumption, transport   colour as RRGGBB
+//   led-delay, led-delay2                               chaser step in ms (0 = profile default)
+//   cooling, sparking                                   fire heat model, 0..255
+//   press                                               button press time in ms (-1 = never)
+//
+// Firmware Serial output is discarded unless HOST_SERIAL is set.
+
+#include <Arduino.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "Config.h"
+#include "SystemState.h"
+#include "Profiles.h"
+#include "effects/Effects.h"
+
+void setup();
+void loop();
+extern SystemState state;
+
+struct Variant {
+    std::string name;
+    EffectLook look;
+    long pressAt;
+};
+
+struct RenderOptions {
+    double seconds = 20.0;
+    long frameMs = 50;
+    int scale = 4;
+    int profile = -1;
+    long pressAt = 1000;
+    std::string outDir = "render";
+};
+
+static bool parseColor(const std::string &value, CRGB &out) {
+    char *end = nullptr;
+    const unsigned long rgb = strtoul(value.c_str(), &end, 16);
+    if (value.size() != 6 || *end) return false;
+    out = CRGB((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+    return true;
+}
+
+static bool parseByte(const std::string &value, uint8_t &out) {
+    char *end = nullptr;
+    const long v = strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end || v < 0 || v > 255) return false;
+    out = (uint8_t)v;
+    return true;
+}
+
+static bool applySetting(Variant &variant, const std::string &key, const std::string &value) {
+    EffectLook &look = variant.look;
+    if (key == "wind") return parseColor(value, look.windColor);
+    if (key == "production") return parseColor(value, look.hydrogenProductionColor);
+    if (key == "storage") return parseColor(value, look.hydrogenStorageColor);
+    if (key == "consumption") return parseColor(value, look.hydrogenConsumptionColor);
+    if (key == "transport") return parseColor(value, look.electricityTransportColor);
+    if (key == "cooling") return parseByte(value, look.fireCooling);
+    if (key == "sparking") return parseByte(value, look.fireSparking);
+
+    char *end = nullptr;
+    const long v = strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end) return false;
+    if (key == "led-delay" && v >= 0 && v <= 0xFFFF) {
+        look.ledDelay = (uint16_t)v;
+        return true;
+    }
+    if (key == "led-delay2" && v >= 0 && v <= 0xFFFF) {
+        look.ledDelay2 = (uint16_t)v;
+        return true;
+    }
+    if (key == "press") {
+        variant.pressAt = v;
+        return true;
+    }
+    return false;
+}
+
+static std::vector<std::string> split(const std::string &text, char separator) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    for (;;) {
+        const size_t end = text.find(separator, start);
+        parts.push_back(text.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+    return parts;
+}
+
+// Expand one "name key=a,b key=c" line into every combination of its values
+static bool expandLine(const std::string &line, long pressAt, std::vector<Variant> &out, const std::string &where) {
+    std::vector<std::string> words;
+    for (const std::string &w : split(line, ' ')) {
+        if (!w.empty()) words.push_back(w);
+    }
+    if (words.empty()) return true;
+
+    std::vector<Variant> partial(1);
+    partial[0].name = words[0];
+    partial[0].pressAt = pressAt;
+    for (size_t i = 1; i < words.size(); ++i) {
+        const size_t eq = words[i].find('=');
+        if (eq == std::string::npos) {
+            fprintf(stderr, "%s: expected key=value, got '%s'\n", where.c_str(), words[i].c_str());
+            return false;
+        }
+        const std::string key = words[i].substr(0, eq);
+        const std::vector<std::string> values = split(words[i].substr(eq + 1), ',');
+        std::vector<Variant> next;
+        for (const Variant &base : partial) {
+            for (const std::string &value : values) {
+                Variant v = base;
+                if (!applySetting(v, key, value)) {
+                    fprintf(stderr, "%s: bad setting %s=%s\n", where.c_str(), key.c_str(), value.c_str());
+                    return false;
+                }
+                // Only swept keys go into the name, so file names stay unique and short
+                if (values.size() > 1) v.name += "_" + key + value;
+                next.push_back(v);
+            }
+        }
+        partial.swap(next);
+    }
+    out.insert(out.end(), partial.begin(), partial.end());
+    return true;
+}
+
+static bool loadVariants(const char *path, long pressAt, std::vector<Variant> &out) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    char buf[1024];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(buf, sizeof(buf), f)) {
+        ++lineNumber;
+        std::string line = buf;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r' || line.back() == '\t')) line.pop_back();
+        ok = expandLine(line, pressAt, out, std::string(path) + ":" + std::to_string(lineNumber));
+    }
+    fclose(f);
+    return ok;
+}
+
+// Dark column between the segments of the active profile (matched by its
+// specialised update, since two profiles may have the same LED count)
+static std::vector<bool> segmentBreaks(int logicalLeds) {
+    std::vector<bool> breaks(logicalLeds, false);
+#define PROFILE_BREAKS(P)                                                                                     \
+    if (state.profile->update == &updateSegmentsFor<P>) {                                                    \
+        const int starts[] = { P::solarStart, P::electricityProductionStart, P::hydrogenProductionStart,     \
+                               P::hydrogenTransportStart, P::hydrogenStorage1Start, P::hydrogenStorage2Start, \
+                               P::hydrogenConsumptionStart, P::electricityTransportStart,                    \
+                               P::storageTransportStart, P::storagePowerstationStart, P::fabricationStart,   \
+                               P::infoStart };                                                               \
+        for (int s : starts) breaks[s] = true;                                                               \
+        return breaks;                                                                                       \
+    }
+    PROFILE_LIST(PROFILE_BREAKS)
+#undef PROFILE_BREAKS
+    return breaks;
+}
+
+// Runs in the worker process: the firmware's globals are this variant's alone
+static int renderVariant(const Variant &variant, const RenderOptions &options) {
+    if (options.profile >= 0 && !profileStore((uint8_t)options.profile)) {
+        fprintf(stderr, "no profile %d\n", options.profile);
+        return 1;
+    }
+    hostUseVirtualClock(true);
+    setup();
+    state.look = variant.look;
+
+    const int leds = state.profile->logicalLeds;
+    const std::vector<bool> breaks = segmentBreaks(leds);
+    int columns = 0;
+    for (int i = 0; i < leds; ++i) columns += options.scale + (breaks[i] ? 1 : 0);
+    const long frames = (long)(options.seconds * 1000.0) / options.frameMs;
+
+    std::vector<uint8_t> image;
+    image.reserve((size_t)columns * 3 * options.scale * frames);
+    std::vector<uint8_t> row((size_t)columns * 3);
+
+    const uint32_t t0 = millis();
+    uint32_t nextFrame = 0;
+    long rendered = 0;
+    while (rendered < frames) {
+        const uint32_t elapsed = millis() - t0;
+        const bool pressed = variant.pressAt >= 0 && elapsed >= (uint32_t)variant.pressAt && elapsed < (uint32_t)variant.pressAt + 100;
+        hostSetPin(BUTTON_PIN, pressed ? LOW : HIGH);
+        loop();
+
+        if (elapsed >= nextFrame) {
+            nextFrame += (uint32_t)options.frameMs;
+            size_t x = 0;
+            for (int i = 0; i < leds; ++i) {
+                if (breaks[i]) {
+                    row[x++] = 40;
+                    row[x++] = 40;
+                    row[x++] = 40;
+                }
+                for (int s = 0; s < options.scale; ++s) {
+                    row[x++] = state.leds[i].r;
+                    row[x++] = state.leds[i].g;
+                    row[x++] = state.leds[i].b;
+                }
+            }
+            for (int s = 0; s < options.scale; ++s) image.insert(image.end(), row.begin(), row.end());
+            ++rendered;
+        }
+        hostAdvanceMillis(1);
+    }
+
+    const std::string path = options.outDir + "/" + variant.name + ".ppm";
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) {
+        perror(path.c_str());
+        return 1;
+    }
+    fprintf(f, "P6\n%d %ld\n255\n", columns, frames * options.scale);
+    bool ok = fwrite(image.data(), 1, image.size(), f) == image.size();
+    ok = fclose(f) == 0 && ok;
+    if (!ok) perror(path.c_str());
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    RenderOptions options;
+    std::vector<std::string> files;
+    std::vector<std::string> sets;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--seconds") && hasValue) {
+            options.seconds = atof(argv[++i]);
+        } else if (!strcmp(a, "--frame-ms") && hasValue) {
+            options.frameMs = atol(argv[++i]);
+        } else if (!strcmp(a, "--scale") && hasValue) {
+            options.scale = atoi(argv[++i]);
+        } else if (!strcmp(a, "--press") && hasValue) {
+            options.pressAt = atol(argv[++i]);
+        } else if (!strcmp(a, "--profile") && hasValue) {
+            options.profile = atoi(argv[++i]);
+        } else if (!strcmp(a, "--jobs") && hasValue) {
+            jobs = atol(argv[++i]);
+        } else if (!strcmp(a, "--set") && hasValue) {
+            sets.push_back(argv[++i]);
+        } else if (!strcmp(a, "-o") && hasValue) {
+            options.outDir = argv[++i];
+        } else if (a[0] != '-') {
+            files.push_back(a);
+        } else {
+            files.clear();
+            sets.clear();
+            break;
+        }
+    }
+    if ((files.empty() && sets.empty()) || options.frameMs < 1 || options.scale < 1 || options.seconds <= 0) {
+        fprintf(stderr, "usage: %s [--seconds N] [--frame-ms MS] [--scale PX] [--press MS] [--profile INDEX]\n"
+                        "       [--jobs N] [-o DIR] (VARIANTS.txt | --set \"name key=value,...\")...\n", argv[0]);
+        return 2;
+    }
+    if (jobs < 1) jobs = 1;
+
+    std::vector<Variant> variants;
+    for (size_t i = 0; i < sets.size(); ++i) {
+        if (!expandLine(sets[i], options.pressAt, variants, "--set")) return 2;
+    }
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!loadVariants(files[i].c_str(), options.pressAt, variants)) return 2;
+    }
+    if (mkdir(options.outDir.c_str(), 0777) != 0 && errno != EEXIST) {
+        perror(options.outDir.c_str());
+        return 1;
+    }
+    if (!getenv("HOST_SERIAL")) setenv("HOST_SERIAL", "/dev/null", 1);
+
+    // Fork one worker per variant, at most `jobs` at a time
+    fflush(stdout);
+    size_t next = 0;
+    long running = 0;
+    int failed = 0;
+    std::vector<pid_t> pids(variants.size(), -1);
+    while (next < variants.size() || running > 0) {
+        if (next < variants.size() && running < jobs) {
+            const pid_t pid = fork();
+            if (pid < 0) {
+                perror("fork");
+                return 1;
+            }
+            if (pid == 0) _exit(renderVariant(variants[next], options));
+            pids[next++] = pid;
+            ++running;
+            continue;
+        }
+        int status = 0;
+        const pid_t done = wait(&status);
+        if (done < 0) break;
+        --running;
+        for (size_t v = 0; v < variants.size(); ++v) {
+            if (pids[v] != done) continue;
+            const bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            if (!ok) ++failed;
+            printf("%s %s/%s.ppm\n", ok ? "ok  " : "FAIL", options.outDir.c_str(), variants[v].name.c_str());
+        }
+    }
+    fflush(stdout);
+    fprintf(stderr, "%zu variants, %d failed\n", variants.size(), failed);
+    return failed ? 1 : 0;
+}
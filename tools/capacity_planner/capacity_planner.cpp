@@ -0,0 +1,326 @@
+// capacity_planner.cpp
+// Host tool: predicts frame rate, loop period and show() blocking time for a
+// WS2812 layout before any hardware is built.
+//
+// WS2812 timing: 24 bits x 1.25 us = 30 us per pixel, followed by a latch
+// (reset) gap of at least 50 us (280 us for newer WS2812B parts). FastLED's
+// ESP32 RMT driver starts all data pins together and show() returns when the
+// longest pin has finished, so pins run in parallel unless --serial-pins is
+// given (bit-banged/clockless drivers send one pin after the other).
+//
+// The loop period is effect cost + output stage + show() + fixed overhead. A
+// timed step (LED_DELAY chasers, fire, gas flow, model) can only fire once per
+// loop pass, so it is attainable only if the loop period is shorter than its
+// interval, and it jitters by up to one loop period.
+//
+//   g++ -std=gnu++11 -O2 -Itools/host -Iinclude -Ilib/fireEffect -Ilib/gasFlow tools/capacity_planner/capacity_planner.cpp -o capacity_planner
+//
+//   capacity_planner                         standard profile layout (trimmed strip, DATA_PIN2 split if set)
+//   capacity_planner --profile compact       another table profile (Profiles.h)
+//   capacity_planner --leds 600 --pins 2     600 pixels split evenly over two pins
+//   capacity_planner --split 300,180,120     explicit pixels per pin
+//   capacity_planner --layout table.txt      segment table: "name start end [cost_us]" per line
+//   capacity_planner --cost fire=850 --cost output=2.1   measured costs (per effect, output per pixel)
+//   capacity_planner --reset-us 280 --serial-pins --target-fps 60
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Config.h"
+#include "fireEffect.h"
+#include "gasFlow.h"
+#include "Topology.h"
+#include "Profiles.h"
+
+struct Segment {
+    std::string name;
+    int start;
+    int end;
+    // Estimated cost of the segment's effect per loop pass, in microseconds
+    double costUs;
+};
+
+struct Interval {
+    const char *name;
+    double ms;
+};
+
+// The planner doesn't link the firmware's Profiles.cpp, so it provides the
+// run tables' storage itself
+#define PROFILE_DEFINE_RUNS(P) constexpr TopologyRun P::runs[];
+PROFILE_LIST(PROFILE_DEFINE_RUNS)
+
+// What the planner takes from a table profile (Profiles.h)
+struct PlannerProfile {
+    const char *name;
+    std::vector<Segment> layout;
+    const TopologyRun *runs;
+    uint8_t runCount;
+    int physicalLeds;
+    uint32_t ledDelay;
+    uint32_t ledDelay2;
+};
+
+// Segments are placed where the profile's run table puts them on the strip.
+// Default costs are rough ESP32 (240 MHz) estimates with every stage active.
+// Replace them with measured numbers (--cost name=us) once they are available.
+template <typename P>
+static PlannerProfile plannerProfile() {
+    const uint8_t runCount = sizeof(P::runs) / sizeof(P::runs[0]);
+    struct Logical {
+        const char *name;
+        int start;
+        int end;
+        double costUs;
+    };
+    const Logical segments[] = {
+        { "wind", P::windStart, P::windEnd, 6 },
+        { "solar", P::solarStart, P::solarEnd, 6 },
+        { "electricity-production", P::electricityProductionStart, P::electricityProductionEnd, 6 },
+        { "hydrogen-production", P::hydrogenProductionStart, P::hydrogenProductionEnd, 25 },
+        { "hydrogen-transport", P::hydrogenTransportStart, P::hydrogenTransportEnd, 40 },
+        { "hydrogen-storage1", P::hydrogenStorage1Start, P::hydrogenStorage1End, 20 },
+        { "hydrogen-storage2", P::hydrogenStorage2Start, P::hydrogenStorage2End, 30 },
+        { "h2-consumption", P::hydrogenConsumptionStart, P::hydrogenConsumptionEnd, 40 },
+        { "electricity-transport", P::electricityTransportStart, P::electricityTransportEnd, 6 },
+        { "storage-transport", P::storageTransportStart, P::storageTransportEnd, 6 },
+        { "storage-powerstation", P::storagePowerstationStart, P::storagePowerstationEnd, 6 },
+        { "fabrication", P::fabricationStart, P::fabricationEnd, 60 },
+        { "info-leds", P::infoStart, P::infoStart + INFO_LED_COUNT - 1, 3 },
+    };
+    PlannerProfile profile;
+    profile.name = P::name();
+    for (size_t i = 0; i < sizeof(segments) / sizeof(segments[0]); ++i) {
+        const int start = topologyPhysicalOf(P::runs, runCount, segments[i].start);
+        const int end = topologyPhysicalOf(P::runs, runCount, segments[i].end);
+        profile.layout.push_back({ segments[i].name, start, end, segments[i].costUs });
+    }
+    profile.runs = P::runs;
+    profile.runCount = runCount;
+    profile.physicalLeds = topologyPhysicalLeds(P::runs);
+    profile.ledDelay = P::ledDelay;
+    profile.ledDelay2 = P::ledDelay2;
+    return profile;
+}
+
+static bool findProfile(const char *name, PlannerProfile &out) {
+#define PROFILE_FIND(P)                   \
+    if (!strcmp(name, P::name())) {       \
+        out = plannerProfile<P>();        \
+        return true;                      \
+    }
+    PROFILE_LIST(PROFILE_FIND)
+#undef PROFILE_FIND
+    return false;
+}
+
+static bool loadLayout(const char *path, std::vector<Segment> &layout) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    layout.clear();
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char name[128];
+        int start, end;
+        double cost = 10;
+        if (line[0] == '#') continue;
+        int n = sscanf(line, "%127s %d %d %lf", name, &start, &end, &cost);
+        if (n >= 3) layout.push_back({ name, start, end, cost });
+    }
+    fclose(f);
+    return !layout.empty();
+}
+
+static std::vector<int> parseSplit(const char *arg) {
+    std::vector<int> split;
+    const char *p = arg;
+    while (*p) {
+        split.push_back(atoi(p));
+        p = strchr(p, ',');
+        if (!p) break;
+        ++p;
+    }
+    return split;
+}
+
+int main(int argc, char **argv) {
+    PlannerProfile profile = plannerProfile<ProfileStandard>();
+    std::vector<Segment> layout;
+    bool customLayout = false;
+    int leds = -1;
+    int pins = 1;
+    std::vector<int> split;
+    double pixelUs = 30.0;
+    double resetUs = 50.0;
+    double outputUsPerPixel = 0.15;   // output stage LUT pass
+    double overheadUs = 150.0;        // button polling, model step, relays, loop bookkeeping
+    double targetFps = 0;
+    bool serialPins = false;
+    std::vector<std::pair<std::string, double> > costs;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--profile") && hasValue) {
+            if (!findProfile(argv[++i], profile)) {
+                fprintf(stderr, "unknown profile '%s'\n", argv[i]);
+                return 2;
+            }
+        } else if (!strcmp(a, "--leds") && hasValue) {
+            leds = atoi(argv[++i]);
+        } else if (!strcmp(a, "--pins") && hasValue) {
+            pins = atoi(argv[++i]);
+        } else if (!strcmp(a, "--split") && hasValue) {
+            split = parseSplit(argv[++i]);
+        } else if (!strcmp(a, "--layout") && hasValue) {
+            if (!loadLayout(argv[++i], layout)) return 1;
+            customLayout = true;
+        } else if (!strcmp(a, "--pixel-us") && hasValue) {
+            pixelUs = atof(argv[++i]);
+        } else if (!strcmp(a, "--reset-us") && hasValue) {
+            resetUs = atof(argv[++i]);
+        } else if (!strcmp(a, "--overhead-us") && hasValue) {
+            overheadUs = atof(argv[++i]);
+        } else if (!strcmp(a, "--target-fps") && hasValue) {
+            targetFps = atof(argv[++i]);
+        } else if (!strcmp(a, "--serial-pins")) {
+            serialPins = true;
+        } else if (!strcmp(a, "--cost") && hasValue) {
+            std::string kv = argv[++i];
+            size_t eq = kv.find('=');
+            if (eq == std::string::npos) {
+                fprintf(stderr, "--cost expects name=us\n");
+                return 2;
+            }
+            costs.push_back(std::make_pair(kv.substr(0, eq), atof(kv.c_str() + eq + 1)));
+        } else {
+            fprintf(stderr, "usage: %s [--profile NAME] [--leds N] [--pins N | --split a,b,..] [--layout FILE] [--cost name=us]...\n"
+                            "       [--pixel-us US] [--reset-us US] [--overhead-us US] [--serial-pins] [--target-fps F]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Profile defaults; only the pixels up to the last mapped one are clocked out
+    if (!customLayout) layout = profile.layout;
+    const bool defaultLeds = leds < 0;
+    if (defaultLeds) leds = profile.physicalLeds;
+    for (size_t c = 0; c < costs.size(); ++c) {
+        bool found = false;
+        if (costs[c].first == "output") {
+            outputUsPerPixel = costs[c].second;
+            found = true;
+        }
+        for (size_t s = 0; s < layout.size(); ++s) {
+            if (layout[s].name == costs[c].first) {
+                layout[s].costUs = costs[c].second;
+                found = true;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "unknown segment '%s'\n", costs[c].first.c_str());
+            return 2;
+        }
+    }
+    printf("Profile %s\n", profile.name);
+
+    // Highest index in the layout decides how many pixels must be clocked out
+    int layoutEnd = 0;
+    for (size_t s = 0; s < layout.size(); ++s) {
+        if (layout[s].end + 1 > layoutEnd) layoutEnd = layout[s].end + 1;
+    }
+    if (layoutEnd > leds) {
+        printf("warning: layout reaches index %d but the strip has %d pixels\n", layoutEnd - 1, leds);
+    }
+
+#ifdef DATA_PIN2
+    if (split.empty() && pins == 1 && defaultLeds && leds > OUTPUT2_FIRST_LED) {
+        split.push_back(topologyUsedBelow(profile.runs, profile.runCount, OUTPUT2_FIRST_LED));
+        split.push_back(leds - OUTPUT2_FIRST_LED);
+        leds = split[0] + split[1];
+    }
+#endif
+    if (split.empty()) {
+        if (pins < 1) pins = 1;
+        for (int p = 0; p < pins; ++p) split.push_back(leds / pins + (p < leds % pins ? 1 : 0));
+    }
+    int splitTotal = 0;
+    for (size_t p = 0; p < split.size(); ++p) splitTotal += split[p];
+    if (splitTotal != leds) {
+        printf("note: pin split covers %d pixels, --leds is %d; using the split\n", splitTotal, leds);
+        leds = splitTotal;
+    }
+
+    // ---- Output timing
+    double showUs = 0;
+    printf("WS2812 output (%.1f us/pixel, %.0f us latch, %s)\n", pixelUs, resetUs, serialPins ? "pins one after another" : "pins in parallel");
+    for (size_t p = 0; p < split.size(); ++p) {
+        double pinUs = split[p] * pixelUs + resetUs;
+        printf("  pin %zu: %4d px  %8.0f us\n", p, split[p], pinUs);
+        showUs = serialPins ? showUs + pinUs : (pinUs > showUs ? pinUs : showUs);
+    }
+
+    // ---- Effect cost
+    double effectsUs = 0;
+    printf("\nEffects (us per loop pass)\n");
+    for (size_t s = 0; s < layout.size(); ++s) {
+        printf("  %-24s %3d-%-3d %8.1f\n", layout[s].name.c_str(), layout[s].start, layout[s].end, layout[s].costUs);
+        effectsUs += layout[s].costUs;
+    }
+    double outputUs = leds * outputUsPerPixel;
+
+    double loopUs = effectsUs + outputUs + showUs + overheadUs;
+    double fps = 1e6 / loopUs;
+
+    printf("\nPer loop pass\n");
+    printf("  effects        %8.0f us\n", effectsUs);
+    printf("  output stage   %8.0f us\n", outputUs);
+    printf("  show() blocks  %8.0f us  (%.0f%% of the loop)\n", showUs, 100.0 * showUs / loopUs);
+    printf("  overhead       %8.0f us\n", overheadUs);
+    printf("  loop period    %8.0f us  -> %.1f fps\n", loopUs, fps);
+
+    // ---- Timed steps from Config.h and the profile
+    const Interval intervals[] = {
+        { "ledDelay (chasers)", (double)profile.ledDelay },
+        { "ledDelay2 (storage transport)", (double)profile.ledDelay2 },
+        { "fire step (FIRE_WAIT_MS)", (double)FIRE_WAIT_MS },
+        { "fire step, reduced (GOVERNOR_FIRE_WAIT_MS)", (double)GOVERNOR_FIRE_WAIT_MS },
+        { "gas flow step (GAS_FLOW_STEP_MS)", (double)GAS_FLOW_STEP_MS },
+        { "model step (MODEL_STEP_MS)", (double)MODEL_STEP_MS },
+        { "button poll (BUTTON_CHECK_INTERVAL)", (double)BUTTON_CHECK_INTERVAL },
+    };
+    printf("\nTimed steps\n");
+    bool allOk = true;
+    for (size_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); ++i) {
+        double periodMs = loopUs / 1000.0;
+        bool ok = periodMs < intervals[i].ms;
+        double jitter = 100.0 * periodMs / intervals[i].ms;
+        printf("  %-42s %6.0f ms  %s  (jitter up to %.1f%%)\n", intervals[i].name, intervals[i].ms,
+               ok ? "ok  " : "MISS", jitter > 100 ? 100.0 : jitter);
+        allOk = allOk && ok;
+    }
+
+    if (targetFps > 0) {
+        // Pixels per pin that still meet the target with the same effect load
+        double budgetUs = 1e6 / targetFps - effectsUs - overheadUs;
+        printf("\nTarget %.0f fps: ", targetFps);
+        // Pins in series pay one latch each; in parallel only the longest pin counts
+        double latchUs = serialPins ? resetUs * split.size() : resetUs;
+        if (budgetUs <= latchUs) {
+            printf("not reachable, effects alone take %.0f us\n", effectsUs + overheadUs);
+            allOk = false;
+        } else {
+            double perPin = (budgetUs - latchUs) / (pixelUs + outputUsPerPixel * (serialPins ? 1.0 : split.size()));
+            printf("at most %.0f pixels %s\n", perPin, serialPins ? "across all pins" : "per pin");
+            if (fps < targetFps) allOk = false;
+        }
+    }
+
+    return allOk ? 0 : 1;
+}
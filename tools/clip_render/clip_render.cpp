@@ -0,0 +1,245 @@
+// clip_render.cpp
+// Host tool: renders a stretch of the firmware's own animation into a
+// prerendered clip (include/ClipPlayer.h) for flash playback.
+//
+// The firmware's setup()/loop() run against the host shim on a virtual clock
+// (one loop pass per millisecond); state.leds is sampled every frame and each
+// sample is delta/run-length coded against the previous one. The written clip
+// is then mmap'ed and played back through the firmware's ClipPlayer to check
+// that every frame decodes to exactly what was rendered.
+//
+//   g++ -std=gnu++11 -O2 -Itools/host -Iinclude -Ilib/fadeLeds -Ilib/fireEffect -Ilib/gasFlow -Ilib/runningLed
+//       tools/clip_render/clip_render.cpp src/main.cpp src/Hardware.cpp src/effects/Effects.cpp src/model/*.cpp
+//       src/utils/*.cpp lib/*/*.cpp tools/host/HostArduino.cpp tools/host/HostFastLED.cpp -o clip_render
+//
+//   clip_render -o idle.clip                          first 12 s after a button press, 40 ms frames
+//   clip_render --from 40000 --seconds 20 -o drain.clip
+//   clip_render --press -1 --seconds 4 -o boot.clip   no press: boot animation only
+//   clip_render --start 0 --count 17 -o wind.clip     only the wind/solar/production segments
+//   clip_render --header include/clips/IdleClip.h --name kIdleClip   PROGMEM header for IDLE_CLIP
+//   clip_render --profile 1 -o compact.clip           render a different table profile (Profiles.h)
+//
+// Serial output of the firmware goes to HOST_SERIAL (default stdout); use
+// HOST_SERIAL=/dev/null to keep the console quiet.
+
+#include <Arduino.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "Config.h"
+#include "SystemState.h"
+#include "ClipPlayer.h"
+#include "FrameCodec.h"
+#include "Profiles.h"
+
+void setup();
+void loop();
+extern SystemState state;
+
+static void putU16(std::vector<uint8_t> &out, uint16_t v) {
+    out.push_back((uint8_t)(v & 0xFF));
+    out.push_back((uint8_t)(v >> 8));
+}
+
+static bool writeFile(const char *path, const std::vector<uint8_t> &data) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    ok = fclose(f) == 0 && ok;
+    if (!ok) perror(path);
+    return ok;
+}
+
+static bool writeHeader(const char *path, const char *name, const std::vector<uint8_t> &clip,
+                        const std::string &command, uint16_t pixels) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "// Generated by tools/clip_render, do not edit:\n//   %s\n\n", command.c_str());
+    fprintf(f, "#pragma once\n\n#include <Arduino.h>\n\n");
+    fprintf(f, "static const uint16_t %sPixels = %u;\n", name, pixels);
+    fprintf(f, "static const uint32_t %sSize = %zu;\n", name, clip.size());
+    fprintf(f, "static const uint8_t %s[] PROGMEM = {", name);
+    for (size_t i = 0; i < clip.size(); ++i) {
+        fprintf(f, "%s0x%02X,", i % 16 ? " " : "\n    ", clip[i]);
+    }
+    fprintf(f, "\n};\n");
+    return fclose(f) == 0;
+}
+
+// Play the clip file back through ClipPlayer from an mmap'ed view and compare
+static bool verifyClip(const char *path, const std::vector<std::vector<uint8_t> > &frames, uint16_t pixels, uint16_t frameMs) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    fstat(fd, &st);
+    void *map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+
+    std::vector<CRGB> leds(pixels);
+    ClipPlayer player;
+    bool ok = clipPlayerStart(player, (const uint8_t *)map, (uint32_t)st.st_size, false, 0);
+    uint32_t now = 0;
+    for (size_t i = 0; ok && i < frames.size(); ++i, now += frameMs) {
+        ok = clipPlayerUpdate(player, leds.data(), 0, now) &&
+             memcmp(leds.data(), frames[i].data(), frames[i].size()) == 0;
+        if (!ok) fprintf(stderr, "verify: frame %zu differs\n", i);
+    }
+    ok = ok && !player.playing;
+    munmap(map, (size_t)st.st_size);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    long pressAt = 0;
+    long fromMs = 0;
+    double seconds = 12.0;
+    long frameMs = 40;
+    int start = 0;
+    int count = -1;
+    const char *outPath = nullptr;
+    const char *headerPath = nullptr;
+    const char *name = "kClip";
+    int profile = -1;
+
+    std::string command = "clip_render";
+    for (int i = 1; i < argc; ++i) {
+        command += " ";
+        command += argv[i];
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--press") && hasValue) {
+            pressAt = atol(argv[++i]);
+        } else if (!strcmp(a, "--from") && hasValue) {
+            fromMs = atol(argv[++i]);
+        } else if (!strcmp(a, "--seconds") && hasValue) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(a, "--frame-ms") && hasValue) {
+            frameMs = atol(argv[++i]);
+        } else if (!strcmp(a, "--start") && hasValue) {
+            start = atoi(argv[++i]);
+        } else if (!strcmp(a, "--count") && hasValue) {
+            count = atoi(argv[++i]);
+        } else if (!strcmp(a, "-o") && hasValue) {
+            outPath = argv[++i];
+        } else if (!strcmp(a, "--header") && hasValue) {
+            headerPath = argv[++i];
+        } else if (!strcmp(a, "--name") && hasValue) {
+            name = argv[++i];
+        } else if (!strcmp(a, "--profile") && hasValue) {
+            profile = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--press MS (-1 = never)] [--from MS] [--seconds N] [--frame-ms MS]\n"
+                            "       [--start I] [--count N] [-o FILE.clip] [--header FILE.h] [--name IDENT] [--profile INDEX]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (profile >= 0 && !profileStore((uint8_t)profile)) {
+        fprintf(stderr, "no profile %d (%u available)\n", profile, kProfileCount);
+        return 2;
+    }
+    // The logical buffer is the one of the profile the firmware will boot with
+    const int logicalLeds = kProfiles[profile >= 0 ? profile : 0].logicalLeds;
+    if (count < 0) count = logicalLeds - start;
+    if (start < 0 || count < 1 || start + count > logicalLeds) {
+        fprintf(stderr, "range %d+%d is outside the %d logical LEDs\n", start, count, logicalLeds);
+        return 2;
+    }
+    if (frameMs < 1 || frameMs > 0xFFFF) {
+        fprintf(stderr, "--frame-ms must be 1..65535\n");
+        return 2;
+    }
+    const long frameTotal = (long)(seconds * 1000.0) / frameMs;
+    if (frameTotal < 1 || frameTotal > 0xFFFF) {
+        fprintf(stderr, "clip would have %ld frames (1..65535)\n", frameTotal);
+        return 2;
+    }
+    if (!outPath && !headerPath) outPath = "out.clip";
+
+    // ---- Render
+    hostUseVirtualClock(true);
+    setup();
+    const uint32_t t0 = millis();
+
+    std::vector<std::vector<uint8_t> > frames;
+    std::vector<uint8_t> clip = { CLIP_MAGIC0, CLIP_MAGIC1, CLIP_MAGIC2, CLIP_MAGIC3, CLIP_VERSION, 0 };
+    putU16(clip, (uint16_t)count);
+    putU16(clip, (uint16_t)frameTotal);
+    putU16(clip, (uint16_t)frameMs);
+
+    std::vector<uint8_t> ops(FRAME_MAX_PAYLOAD(count));
+    size_t largest = 0;
+    uint32_t nextFrame = (uint32_t)fromMs;
+    while ((long)frames.size() < frameTotal) {
+        const uint32_t elapsed = millis() - t0;
+        const bool pressed = pressAt >= 0 && elapsed >= (uint32_t)pressAt && elapsed < (uint32_t)pressAt + 100;
+        hostSetPin(BUTTON_PIN, pressed ? LOW : HIGH);
+        loop();
+
+        if (elapsed >= nextFrame) {
+            nextFrame += (uint32_t)frameMs;
+            const uint8_t *pixels = reinterpret_cast<const uint8_t *>(state.leds + start);
+            const uint8_t *prev = frames.empty() ? nullptr : frames.back().data();
+            size_t length = 0;
+            if (!frameEncodeOps(pixels, prev, (uint16_t)count, ops.data(), ops.size(), &length)) {
+                fprintf(stderr, "frame %zu does not fit the op buffer\n", frames.size());
+                return 1;
+            }
+            putU16(clip, (uint16_t)length);
+            clip.insert(clip.end(), ops.begin(), ops.begin() + length);
+            frames.push_back(std::vector<uint8_t>(pixels, pixels + count * 3));
+            if (length > largest) largest = length;
+        }
+        hostAdvanceMillis(1);
+    }
+
+    // ---- Write and check
+    char tmpPath[] = "/tmp/clip_render_XXXXXX";
+    const char *verifyPath = outPath;
+    if (outPath) {
+        if (!writeFile(outPath, clip)) return 1;
+    } else {
+        int fd = mkstemp(tmpPath);
+        if (fd < 0) {
+            perror("mkstemp");
+            return 1;
+        }
+        close(fd);
+        if (!writeFile(tmpPath, clip)) return 1;
+        verifyPath = tmpPath;
+    }
+    const bool verified = verifyClip(verifyPath, frames, (uint16_t)count, (uint16_t)frameMs);
+    if (!outPath) unlink(tmpPath);
+    if (!verified) {
+        fprintf(stderr, "verify failed\n");
+        return 1;
+    }
+    if (headerPath && !writeHeader(headerPath, name, clip, command, (uint16_t)count)) return 1;
+
+    const size_t raw = frames.size() * (size_t)count * 3;
+    fprintf(stderr, "%zu frames x %d px @ %ld ms: %zu bytes (raw %zu, %.1f%%), largest frame %zu bytes\n",
+            frames.size(), count, frameMs, clip.size(), raw, 100.0 * clip.size() / raw, largest + 2);
+    return 0;
+}
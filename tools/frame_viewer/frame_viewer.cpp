@@ -0,0 +1,247 @@
+// frame_viewer.cpp
+// Host viewer for the firmware's serial frame mirror (FRAME_MIRROR in Config.h).
+// Decodes the packet stream (include/FrameCodec.h) from a serial device, a pty
+// or stdin and draws the strip segment by segment with ANSI truecolour.
+//
+//   g++ -std=gnu++11 -O2 -Itools/host -Iinclude tools/frame_viewer/frame_viewer.cpp src/utils/FrameCodec.cpp -o frame_viewer
+//
+//   frame_viewer /dev/ttyUSB0            read the board at 115200 baud
+//   frame_viewer --baud 230400 /dev/ttyUSB0
+//   frame_viewer --pty                   create a pty, print its path, read from it
+//   host_firmware | frame_viewer -       read stdin (e.g. the host build of the firmware)
+//   frame_viewer --frames 100 ...        exit after 100 decoded frames
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Config.h"
+#include "FrameCodec.h"
+#include "Profiles.h"
+
+struct Segment {
+    const char *name;
+    int start;
+    int end;
+};
+
+// Logical segments of a table profile (the mirror streams the logical buffer)
+template <typename P>
+static std::vector<Segment> profileSegments() {
+    const Segment segments[] = {
+        { "Wind", P::windStart, P::windEnd },
+        { "Solar", P::solarStart, P::solarEnd },
+        { "Electricity production", P::electricityProductionStart, P::electricityProductionEnd },
+        { "Hydrogen production", P::hydrogenProductionStart, P::hydrogenProductionEnd },
+        { "Hydrogen transport", P::hydrogenTransportStart, P::hydrogenTransportEnd },
+        { "Hydrogen storage 1", P::hydrogenStorage1Start, P::hydrogenStorage1End },
+        { "Hydrogen storage 2", P::hydrogenStorage2Start, P::hydrogenStorage2End },
+        { "H2 consumption", P::hydrogenConsumptionStart, P::hydrogenConsumptionEnd },
+        { "Electricity transport", P::electricityTransportStart, P::electricityTransportEnd },
+        { "Storage transport", P::storageTransportStart, P::storageTransportEnd },
+        { "Storage powerstation", P::storagePowerstationStart, P::storagePowerstationEnd },
+        { "Fabrication", P::fabricationStart, P::fabricationEnd },
+        { "Info LEDs", P::infoStart, P::logicalLeds - 1 },
+    };
+    return std::vector<Segment>(segments, segments + sizeof(segments) / sizeof(segments[0]));
+}
+
+// The frame's pixel count tells which profile the board runs (first match wins)
+static std::vector<Segment> segmentsFor(int count) {
+#define PROFILE_MATCH(P) \
+    if (count == P::logicalLeds) return profileSegments<P>();
+    PROFILE_LIST(PROFILE_MATCH)
+#undef PROFILE_MATCH
+    return profileSegments<ProfileStandard>();
+}
+
+static const int kMaxPixels = 1024;
+
+static double nowSeconds() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static speed_t baudConstant(long baud) {
+    switch (baud) {
+    case 9600: return B9600;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default: return B115200;
+    }
+}
+
+static bool makeRaw(int fd, long baud) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) return false;
+    cfmakeraw(&tio);
+    if (baud > 0) {
+        cfsetispeed(&tio, baudConstant(baud));
+        cfsetospeed(&tio, baudConstant(baud));
+    }
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+static void appendPixel(std::string &out, const uint8_t *px) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "\x1b[48;2;%u;%u;%um  ", px[0], px[1], px[2]);
+    out += buf;
+}
+
+static void render(const uint8_t *pixels, int count, const FrameStreamDecoder &decoder, double fps, unsigned long textBytes) {
+    std::string out;
+    out.reserve(16384);
+    out += "\x1b[H";
+
+    const std::vector<Segment> segments = segmentsFor(count);
+    for (size_t s = 0; s < segments.size(); ++s) {
+        char label[64];
+        snprintf(label, sizeof(label), "%-24s %3d-%-3d ", segments[s].name, segments[s].start, segments[s].end);
+        out += label;
+        for (int i = segments[s].start; i <= segments[s].end; ++i) {
+            if (i < count) {
+                appendPixel(out, pixels + i * 3);
+            } else {
+                out += "\x1b[0m ..";
+            }
+        }
+        out += "\x1b[0m\x1b[K\n";
+    }
+
+    // Whole strip, 40 pixels per row
+    out += "\n";
+    for (int row = 0; row < count; row += 40) {
+        char label[16];
+        snprintf(label, sizeof(label), "%4d ", row);
+        out += label;
+        for (int i = row; i < row + 40 && i < count; ++i) appendPixel(out, pixels + i * 3);
+        out += "\x1b[0m\x1b[K\n";
+    }
+
+    char stats[160];
+    double raw = FRAME_HEADER_BYTES + count * 3 + FRAME_TRAILER_BYTES;
+    snprintf(stats, sizeof(stats), "\n%d px  %.1f fps  last packet %u B (%.0f%% of raw)  frames %u  dropped %u  text bytes %lu\x1b[K\n",
+             count, fps, decoder.bytesInLastPacket(), 100.0 * decoder.bytesInLastPacket() / raw,
+             decoder.framesDecoded(), decoder.packetsDropped(), textBytes);
+    out += stats;
+
+    fwrite(out.data(), 1, out.size(), stdout);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    long baud = 115200;
+    long maxFrames = -1;
+    bool usePty = false;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--baud") && i + 1 < argc) {
+            baud = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            maxFrames = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--pty")) {
+            usePty = true;
+        } else if (argv[i][0] != '-' || !strcmp(argv[i], "-")) {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            usePty = false;
+            break;
+        }
+    }
+    if (!usePty && !path) {
+        fprintf(stderr, "usage: %s [--baud N] [--frames N] (--pty | DEVICE | -)\n", argv[0]);
+        return 2;
+    }
+
+    int fd = -1;
+    int ptySlave = -1;
+    if (usePty) {
+        fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+            perror("posix_openpt");
+            return 1;
+        }
+        const char *slave = ptsname(fd);
+        // Hold the slave open in raw mode: no newline translation, and no EIO between writers
+        ptySlave = open(slave, O_RDWR | O_NOCTTY);
+        if (ptySlave < 0 || !makeRaw(ptySlave, 0)) {
+            perror(slave);
+            return 1;
+        }
+        fprintf(stderr, "frame_viewer: reading from %s (e.g. HOST_SERIAL=%s host_firmware)\n", slave, slave);
+    } else if (!strcmp(path, "-")) {
+        fd = STDIN_FILENO;
+    } else {
+        fd = open(path, O_RDONLY | O_NOCTTY);
+        if (fd < 0) {
+            perror(path);
+            return 1;
+        }
+        if (isatty(fd) && !makeRaw(fd, baud)) {
+            perror("tcsetattr");
+            return 1;
+        }
+    }
+
+    static uint8_t pixels[kMaxPixels * 3];
+    static uint8_t packetBuffer[FRAME_DECODER_BUFFER(kMaxPixels)];
+    FrameStreamDecoder decoder(pixels, kMaxPixels, packetBuffer);
+
+    fputs("\x1b[2J", stdout);
+    double lastDraw = 0;
+    double fpsWindowStart = nowSeconds();
+    unsigned fpsFrames = 0;
+    double fps = 0;
+    unsigned long bytesTotal = 0;
+    unsigned long packetBytes = 0;
+
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        bytesTotal += (unsigned long)n;
+
+        bool fresh = false;
+        for (ssize_t i = 0; i < n; ++i) {
+            if (decoder.feed(buf[i])) {
+                fresh = true;
+                ++fpsFrames;
+                packetBytes += decoder.bytesInLastPacket();
+                if (maxFrames > 0 && (long)decoder.framesDecoded() >= maxFrames) break;
+            }
+        }
+
+        double t = nowSeconds();
+        if (t - fpsWindowStart >= 1.0) {
+            fps = fpsFrames / (t - fpsWindowStart);
+            fpsFrames = 0;
+            fpsWindowStart = t;
+        }
+        if (fresh && t - lastDraw >= 1.0 / 60) {
+            render(pixels, decoder.pixelCount(), decoder, fps, bytesTotal > packetBytes ? bytesTotal - packetBytes : 0);
+            lastDraw = t;
+        }
+        if (maxFrames > 0 && (long)decoder.framesDecoded() >= maxFrames) break;
+    }
+
+    render(pixels, decoder.pixelCount(), decoder, fps, bytesTotal > packetBytes ? bytesTotal - packetBytes : 0);
+    fputs("\x1b[0m", stdout);
+    if (ptySlave >= 0) close(ptySlave);
+    return 0;
+}
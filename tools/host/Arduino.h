@@ -0,0 +1,88 @@
+// Arduino.h (host build)
+// Minimal stand-in for the Arduino core so firmware sources and host tools
+// can be compiled and run on a desktop. Only what this project uses is here.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+#define PROGMEM
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+inline uint8_t pgm_read_byte(const void *p) { return *(const uint8_t *)p; }
+
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    // Like the ESP32 core: a TX ring buffer of this size, else only the hardware FIFO
+    size_t setTxBufferSize(size_t size) { txBufferSize = size; return size; }
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t write(const uint8_t *data, size_t length);
+    int availableForWrite();
+    int available();
+    int read();
+
+    size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v, int base = DEC) { return printNumber((long)v, base); }
+    size_t print(unsigned v, int base = DEC) { return printNumber((unsigned long)v, base); }
+    size_t print(long v, int base = DEC) { return printNumber(v, base); }
+    size_t print(unsigned long v, int base = DEC) { return printNumber(v, base); }
+    size_t print(double v, int digits = 2);
+    template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(T v, int f) { size_t n = print(v, f); return n + println(); }
+    size_t println() { return print("\r\n"); }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+    size_t printNumber(long v, int base);
+    size_t txBufferSize = 0;
+    size_t printNumber(unsigned long v, int base);
+};
+
+extern HardwareSerial Serial;
+
+// Host-only controls for the simulated board. Clock and pins are per thread.
+// Use a virtual clock that only moves through hostAdvanceMillis()/delay()
+void hostUseVirtualClock(bool on);
+void hostAdvanceMillis(uint32_t ms);
+// Jump the virtual clock, e.g. to just before the 32-bit millis() wraparound
+void hostSetMillis(uint32_t ms);
+// Size of the UART hardware TX FIFO reported by availableForWrite() when no TX
+// buffer is set (ESP32: 128). Writes on the host never wait, so the whole
+// buffer is always free.
+void hostSetSerialFifo(size_t bytes);
+// Drive an input pin (e.g. BUTTON_PIN) from the host
+void hostSetPin(uint8_t pin, int value);
+int hostPinValue(uint8_t pin);
+
+// Heap accounting: the host build replaces operator new/delete with a tracking allocator
+struct HostHeapStats {
+    size_t inUse;
+    size_t peak;
+    uint32_t allocations;
+    uint32_t frees;
+};
+HostHeapStats hostHeapStats();
+
+// Stack high-water: paint `bytes` of stack below the caller (call early in main);
+// hostStackUsed() then returns the deepest use below that point so far, or 0
+size_t hostStackPaint(size_t bytes);
+size_t hostStackUsed();
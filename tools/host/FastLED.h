@@ -0,0 +1,91 @@
+// FastLED.h (host build)
+// Subset of FastLED used by this project: CRGB, the 8-bit math helpers,
+// HeatColor and a FastLED object whose show() hands the frame to a host hook.
+
+#pragma once
+
+#include "Arduino.h"
+
+struct CRGB {
+    union {
+        struct {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+        };
+        uint8_t raw[3];
+    };
+
+    enum HTMLColorCode {
+        Black = 0x000000,
+        White = 0xFFFFFF,
+        Red = 0xFF0000,
+        Green = 0x008000,
+        Blue = 0x0000FF,
+        Yellow = 0xFFFF00
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    constexpr CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(HTMLColorCode c) : r((c >> 16) & 0xFF), g((c >> 8) & 0xFF), b(c & 0xFF) {}
+
+    uint8_t &operator[](uint8_t i) { return raw[i]; }
+    const uint8_t &operator[](uint8_t i) const { return raw[i]; }
+};
+
+inline bool operator==(const CRGB &a, const CRGB &b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+inline bool operator!=(const CRGB &a, const CRGB &b) { return !(a == b); }
+
+void fill_solid(CRGB *leds, int count, const CRGB &color);
+
+inline uint8_t qadd8(uint8_t a, uint8_t b) { unsigned s = a + b; return s > 255 ? 255 : (uint8_t)s; }
+inline uint8_t qsub8(uint8_t a, uint8_t b) { return a > b ? (uint8_t)(a - b) : 0; }
+inline uint8_t scale8(uint8_t i, uint8_t scale) { return (uint8_t)(((uint16_t)i * (1 + (uint16_t)scale)) >> 8); }
+inline uint8_t scale8_video(uint8_t i, uint8_t scale) { return (uint8_t)((((uint16_t)i * scale) >> 8) + ((i && scale) ? 1 : 0)); }
+
+uint8_t random8();
+uint8_t random8(uint8_t lim);
+uint8_t random8(uint8_t min, uint8_t lim);
+uint16_t random16();
+void random16_set_seed(uint16_t seed);
+
+CRGB HeatColor(uint8_t temperature);
+
+enum ESPIChipsets { WS2812 };
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+class CLEDController {};
+
+class CFastLED {
+public:
+    template <ESPIChipsets CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CLEDController &addLeds(CRGB *data, int count, int offset = 0) {
+        attach(data + offset, count, DATA_PIN);
+        return controller;
+    }
+    void setBrightness(uint8_t b) { brightness = b; }
+    uint8_t getBrightness() const { return brightness; }
+    void show();
+
+    // Host hook: called from show() with every attached buffer
+    typedef void (*ShowHook)(const CRGB *leds, int count, uint8_t pin);
+    void setShowHook(ShowHook hook) { showHook = hook; }
+    uint32_t showCount() const { return shows; }
+
+private:
+    void attach(CRGB *data, int count, uint8_t pin);
+
+    CLEDController controller;
+    struct Output {
+        CRGB *data;
+        int count;
+        uint8_t pin;
+    } outputs[4];
+    int outputCount = 0;
+    uint8_t brightness = 255;
+    ShowHook showHook = nullptr;
+    uint32_t shows = 0;
+};
+
+// One per thread, like the clock and pins in Arduino.h
+extern thread_local CFastLED FastLED;
@@ -0,0 +1,210 @@
+#include "Arduino.h"
+
+#include <alloca.h>
+#include <chrono>
+#include <fcntl.h>
+#include <mutex>
+#include <new>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+
+// ---- Clock
+
+// Clock and pins are per thread, so tools/soak can run one simulated board per thread
+static thread_local bool virtualClock = false;
+static thread_local uint32_t virtualMillis = 0;
+
+static uint64_t realMicros() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void hostUseVirtualClock(bool on) { virtualClock = on; }
+void hostAdvanceMillis(uint32_t ms) { virtualMillis += ms; }
+void hostSetMillis(uint32_t ms) { virtualMillis = ms; }
+
+uint32_t millis() { return virtualClock ? virtualMillis : (uint32_t)(realMicros() / 1000); }
+uint32_t micros() { return virtualClock ? virtualMillis * 1000u : (uint32_t)realMicros(); }
+
+void delay(uint32_t ms) {
+    if (virtualClock) {
+        virtualMillis += ms;
+    } else {
+        usleep((useconds_t)ms * 1000);
+    }
+}
+
+// ---- GPIO
+
+static thread_local int pinValues[64];
+static thread_local bool pinsInitialised = false;
+
+static void initPins() {
+    if (pinsInitialised) return;
+    // Inputs idle high (pull-ups, button released)
+    for (int i = 0; i < 64; ++i) pinValues[i] = HIGH;
+    pinsInitialised = true;
+}
+
+void pinMode(uint8_t, uint8_t) { initPins(); }
+void digitalWrite(uint8_t pin, uint8_t value) { initPins(); if (pin < 64) pinValues[pin] = value; }
+int digitalRead(uint8_t pin) { initPins(); return pin < 64 ? pinValues[pin] : LOW; }
+void hostSetPin(uint8_t pin, int value) { digitalWrite(pin, (uint8_t)value); }
+int hostPinValue(uint8_t pin) { return digitalRead(pin); }
+
+// ---- Serial: stdout, or the device/pty named by HOST_SERIAL
+
+static int openSerial() {
+    const char *path = getenv("HOST_SERIAL");
+    const int fd = path ? open(path, O_RDWR | O_NOCTTY) : STDOUT_FILENO;
+    return fd < 0 ? STDOUT_FILENO : fd;
+}
+
+static int serialFd() {
+    static const int fd = openSerial();
+    return fd;
+}
+
+size_t HardwareSerial::write(const uint8_t *data, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = ::write(serialFd(), data + done, length - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    return done;
+}
+
+static size_t serialFifo = 128;
+
+void hostSetSerialFifo(size_t bytes) { serialFifo = bytes; }
+
+int HardwareSerial::availableForWrite() { return (int)(txBufferSize ? txBufferSize : serialFifo); }
+
+// Input comes from HOST_SERIAL when set, otherwise stdin (e.g. type 'm' + Enter)
+static int peekedByte = -1;
+
+int HardwareSerial::available() {
+    if (peekedByte >= 0) return 1;
+    struct pollfd p;
+    p.fd = getenv("HOST_SERIAL") ? serialFd() : STDIN_FILENO;
+    p.events = POLLIN;
+    p.revents = 0;
+    uint8_t b;
+    if (poll(&p, 1, 0) > 0 && (p.revents & POLLIN) && ::read(p.fd, &b, 1) == 1) {
+        peekedByte = b;
+        return 1;
+    }
+    return 0;
+}
+
+int HardwareSerial::read() {
+    if (!available()) return -1;
+    int b = peekedByte;
+    peekedByte = -1;
+    return b;
+}
+
+size_t HardwareSerial::print(double v, int digits) {
+    char buf[48];
+    int n = snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write((const uint8_t *)buf, (size_t)n);
+}
+
+size_t HardwareSerial::printNumber(long v, int base) {
+    char buf[40];
+    int n = base == HEX ? snprintf(buf, sizeof(buf), "%lX", (unsigned long)v) : snprintf(buf, sizeof(buf), "%ld", v);
+    return write((const uint8_t *)buf, (size_t)n);
+}
+
+size_t HardwareSerial::printNumber(unsigned long v, int base) {
+    char buf[40];
+    int n = snprintf(buf, sizeof(buf), base == HEX ? "%lX" : "%lu", v);
+    return write((const uint8_t *)buf, (size_t)n);
+}
+
+size_t HardwareSerial::printf(const char *format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t *)buf, (size_t)(n < (int)sizeof(buf) ? n : (int)sizeof(buf) - 1));
+}
+
+// ---- Heap: tracking operator new/delete
+// Each block carries a 16-byte header with its size so frees can be counted
+// in bytes; 16 keeps the returned pointer aligned like malloc's.
+
+static HostHeapStats heapStats;
+static std::mutex heapLock;
+static const size_t kHeapHeader = 16;
+
+static void *trackedAlloc(size_t n) {
+    uint8_t *p = (uint8_t *)malloc(n + kHeapHeader);
+    if (!p) return nullptr;
+    *(size_t *)p = n;
+    std::lock_guard<std::mutex> lock(heapLock);
+    heapStats.inUse += n;
+    if (heapStats.inUse > heapStats.peak) heapStats.peak = heapStats.inUse;
+    ++heapStats.allocations;
+    return p + kHeapHeader;
+}
+
+static void trackedFree(void *ptr) {
+    if (!ptr) return;
+    uint8_t *p = (uint8_t *)ptr - kHeapHeader;
+    {
+        std::lock_guard<std::mutex> lock(heapLock);
+        heapStats.inUse -= *(size_t *)p;
+        ++heapStats.frees;
+    }
+    free(p);
+}
+
+HostHeapStats hostHeapStats() {
+    std::lock_guard<std::mutex> lock(heapLock);
+    return heapStats;
+}
+
+void *operator new(size_t n) {
+    void *p = trackedAlloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void *operator new[](size_t n) { return operator new(n); }
+void *operator new(size_t n, const std::nothrow_t &) noexcept { return trackedAlloc(n); }
+void *operator new[](size_t n, const std::nothrow_t &) noexcept { return trackedAlloc(n); }
+void operator delete(void *p) noexcept { trackedFree(p); }
+void operator delete[](void *p) noexcept { trackedFree(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { trackedFree(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { trackedFree(p); }
+
+// ---- Stack: paint below the caller, later find the deepest overwritten byte
+
+static const uint8_t kStackPaint = 0xA5;
+static uint8_t *stackPaintLow = nullptr;
+static uint8_t *stackPaintTop = nullptr;
+
+__attribute__((noinline)) size_t hostStackPaint(size_t bytes) {
+    uint8_t *area = (uint8_t *)alloca(bytes);
+    memset(area, kStackPaint, bytes);
+    // keep the stores: nothing reads the area in this frame
+    __asm__ volatile("" : : "r"(area) : "memory");
+    stackPaintLow = area;
+    stackPaintTop = area + bytes;
+    return bytes;
+}
+
+// Reads stack below the live frames, so it must not be instrumented
+__attribute__((noinline, no_sanitize_address)) size_t hostStackUsed() {
+    if (!stackPaintLow) return 0;
+    const volatile uint8_t *p = stackPaintLow;
+    while (p < stackPaintTop && *p == kStackPaint) ++p;
+    return (size_t)(stackPaintTop - p);
+}
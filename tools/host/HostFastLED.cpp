@@ -0,0 +1,63 @@
+#include "FastLED.h"
+
+thread_local CFastLED FastLED;
+
+void fill_solid(CRGB *leds, int count, const CRGB &color) {
+    for (int i = 0; i < count; ++i) leds[i] = color;
+}
+
+// Same generator as FastLED's lib8tion so host runs look like the board
+static thread_local uint16_t rand16seed = 1337;
+
+uint16_t random16() {
+    rand16seed = (uint16_t)(rand16seed * 2053 + 13849);
+    return rand16seed;
+}
+
+void random16_set_seed(uint16_t seed) { rand16seed = seed; }
+
+uint8_t random8() {
+    random16();
+    return (uint8_t)((uint8_t)(rand16seed & 0xFF) + (uint8_t)(rand16seed >> 8));
+}
+
+uint8_t random8(uint8_t lim) { return (uint8_t)(((uint16_t)random8() * lim) >> 8); }
+
+uint8_t random8(uint8_t min, uint8_t lim) { return (uint8_t)(random8((uint8_t)(lim - min)) + min); }
+
+CRGB HeatColor(uint8_t temperature) {
+    CRGB heatcolor;
+    // Scale 'heat' down from 0-255 to 0-191, which can then be easily divided into three equal 'thirds' of 64 units each
+    uint8_t t192 = scale8_video(temperature, 191);
+    uint8_t heatramp = (uint8_t)((t192 & 0x3F) << 2);
+
+    if (t192 & 0x80) {
+        heatcolor.r = 255;
+        heatcolor.g = 255;
+        heatcolor.b = heatramp;
+    } else if (t192 & 0x40) {
+        heatcolor.r = 255;
+        heatcolor.g = heatramp;
+        heatcolor.b = 0;
+    } else {
+        heatcolor.r = heatramp;
+        heatcolor.g = 0;
+        heatcolor.b = 0;
+    }
+    return heatcolor;
+}
+
+void CFastLED::attach(CRGB *data, int count, uint8_t pin) {
+    if (outputCount < 4) {
+        outputs[outputCount].data = data;
+        outputs[outputCount].count = count;
+        outputs[outputCount].pin = pin;
+        ++outputCount;
+    }
+}
+
+void CFastLED::show() {
+    ++shows;
+    if (!showHook) return;
+    for (int i = 0; i < outputCount; ++i) showHook(outputs[i].data, outputs[i].count, outputs[i].pin);
+}
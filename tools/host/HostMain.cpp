@@ -0,0 +1,108 @@
+// HostMain.cpp
+// Runs the firmware's setup()/loop() on the host against the Arduino/FastLED
+// stand-ins in this directory. Serial output goes to stdout, or to the device
+// or pty named by HOST_SERIAL.
+//
+//   g++ -std=gnu++11 -O2 -Itools/host -Iinclude -Ilib/fadeLeds -Ilib/fireEffect -Ilib/gasFlow -Ilib/runningLed
+//       src/main.cpp src/Hardware.cpp src/effects/Effects.cpp src/model/*.cpp src/utils/*.cpp lib/*/*.cpp
+//       tools/host/*.cpp -o host_firmware
+//
+//   host_firmware [--seconds N] [--press MS] [--virtual STEP_MS] [--profile INDEX] [--trace FILE]
+//
+// Add -DFRAME_MIRROR=1 to stream frames to tools/frame_viewer. Serial input is
+// read from stdin (or HOST_SERIAL), so typing 'm' + Enter prints the memory report.
+// --profile stores a table profile (Profiles.h) in the stand-in Preferences
+// before setup(), as if it had been chosen over Serial on an earlier boot.
+// Built with -DTRACE_EVENTS=7 (Config.h), --trace writes the event trace as
+// Chrome trace JSON when the run ends; open it in ui.perfetto.dev.
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Config.h"
+#include "Profiles.h"
+#include "SystemState.h"
+
+void setup();
+void loop();
+extern SystemState state;
+
+#if TRACE_EVENTS
+static void writeFile(void *context, const char *text) {
+    fputs(text, (FILE *)context);
+}
+#endif
+
+int main(int argc, char **argv) {
+    double seconds = 120.0;
+    long pressAt = 1000;
+    long virtualStep = 0;
+    int profile = -1;
+    const char *tracePath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--press") && i + 1 < argc) {
+            pressAt = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--virtual") && i + 1 < argc) {
+            virtualStep = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--profile") && i + 1 < argc) {
+            profile = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--press MS (-1 = never)] [--virtual STEP_MS] [--profile INDEX] [--trace FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (profile >= 0 && !profileStore((uint8_t)profile)) {
+        fprintf(stderr, "no profile %d (%u available)\n", profile, kProfileCount);
+        return 2;
+    }
+#if !TRACE_EVENTS
+    if (tracePath) {
+        fprintf(stderr, "--trace needs a build with -DTRACE_EVENTS=7 (or another TRACE_EVENTS mask)\n");
+        return 2;
+    }
+#endif
+
+    hostUseVirtualClock(virtualStep > 0);
+    // for the stack high-water line of the memory report ('m' on stdin)
+    hostStackPaint(128 * 1024);
+    setup();
+
+    const uint32_t start = millis();
+    const uint32_t runMs = (uint32_t)(seconds * 1000.0);
+    for (;;) {
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= runMs) break;
+
+        // Hold the button for 100 ms at the requested time
+        bool pressed = pressAt >= 0 && elapsed >= (uint32_t)pressAt && elapsed < (uint32_t)pressAt + 100;
+        hostSetPin(BUTTON_PIN, pressed ? LOW : HIGH);
+
+        loop();
+
+        if (virtualStep > 0) {
+            hostAdvanceMillis((uint32_t)virtualStep);
+        } else {
+            usleep(1000);
+        }
+    }
+#if TRACE_EVENTS
+    if (tracePath) {
+        FILE *f = fopen(tracePath, "w");
+        if (!f) {
+            perror(tracePath);
+            return 1;
+        }
+        traceWriteJson(state.trace, writeFile, f);
+        fclose(f);
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Preferences.h
+// Host stand-in for the ESP32 Preferences (NVS) library: a small fixed table
+// that lives for the run of the process (no heap, so the memory report still
+// shows what the firmware itself allocates). Only the calls the firmware uses
+// are provided.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+class Preferences {
+public:
+    bool begin(const char *name, bool readOnly = false) {
+        snprintf(space, sizeof(space), "%s", name);
+        this->readOnly = readOnly;
+        return true;
+    }
+    void end() { space[0] = '\0'; }
+
+    uint8_t getUChar(const char *key, uint8_t defaultValue = 0) {
+        Entry *e = find(key, false);
+        return e ? e->value : defaultValue;
+    }
+    size_t putUChar(const char *key, uint8_t value) {
+        Entry *e = readOnly ? nullptr : find(key, true);
+        if (!e) return 0;
+        e->value = value;
+        return 1;
+    }
+    bool remove(const char *key) {
+        Entry *e = readOnly ? nullptr : find(key, false);
+        if (!e) return false;
+        e->used = false;
+        return true;
+    }
+
+private:
+    struct Entry {
+        bool used;
+        char key[48];
+        uint8_t value;
+    };
+
+    Entry *find(const char *key, bool create) {
+        static Entry entries[16];
+        char full[48];
+        snprintf(full, sizeof(full), "%s/%s", space, key);
+        Entry *free = nullptr;
+        for (Entry &e : entries) {
+            if (e.used && !strcmp(e.key, full)) return &e;
+            if (!e.used && !free) free = &e;
+        }
+        if (!create || !free) return nullptr;
+        free->used = true;
+        snprintf(free->key, sizeof(free->key), "%s", full);
+        return free;
+    }
+
+    char space[16] = "";
+    bool readOnly = false;
+};
@@ -0,0 +1,374 @@
+// soak.cpp
+// Host tool: randomized soak test of the demo cycle. Many independent
+// simulated boards run in parallel threads, each with its own SystemState,
+// Timers, virtual clock, pins and FastLED (all per thread in tools/host), and
+// each driven by its own random schedule:
+//   - button presses at random gaps (short, mid-run, long idle), held for a
+//     random time with contact bounce, now and then held for minutes
+//   - loop periods of 1..--step ms with the occasional multi-second stall
+//   - a start clock anywhere in the 32-bit millis() range; every other
+//     instance starts shortly before the wraparound
+// After every loop pass the invariants are checked:
+//   - nothing is written past the active profile's logical LEDs (the tail of
+//     state.leds and the LED_GUARD_PIXELS guard behind it stay black)
+//   - every run lasts RUN_TIME_MS (no longer, and no shorter), the wind relay
+//     is off after WIND_TIME_MS
+//   - the pass that ends a run leaves both relays off, every stage flag
+//     cleared and every logical LED black, and the relays stay off until the
+//     next press
+// Everything an instance does follows from its seed, so a failure is
+// reproduced with the "rerun:" line printed next to it.
+//
+//   g++ -std=gnu++11 -O2 -pthread -DLED_GUARD_PIXELS=16 -Itools/host -Iinclude -Ilib/fadeLeds -Ilib/fireEffect
+//       -Ilib/gasFlow -Ilib/runningLed tools/soak/soak.cpp src/Hardware.cpp src/effects/Effects.cpp src/model/*.cpp
+//       src/utils/*.cpp lib/*/*.cpp tools/host/HostArduino.cpp tools/host/HostFastLED.cpp -o soak
+//
+//   soak                                    one instance per core, 24 simulated hours each
+//   soak --instances 64 --hours 72          64 instances over the available cores
+//   soak --seed 1234 --instances 1          rerun one instance
+//   soak --profile 1 --step 5               compact profile only, faster loop
+//
+// Firmware Serial output is discarded unless HOST_SERIAL is set.
+
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Config.h"
+#include "SystemState.h"
+#include "Hardware.h"
+#include "DemoCycle.h"
+#include "Profiles.h"
+
+struct SoakOptions {
+    double hours = 24.0;
+    uint32_t maxStepMs = 20;
+    int profile = -1;
+    uint64_t seed = 1;
+    int instances = 0;
+    int threads = 0;
+};
+
+struct SoakResult {
+    uint64_t passes = 0;
+    uint64_t simulatedMs = 0;
+    uint32_t presses = 0;
+    uint32_t runs = 0;
+    uint32_t wraps = 0;
+    bool failed = false;
+};
+
+// One simulated board
+struct Instance {
+    SystemState state;
+    Timers timers;
+};
+
+// xorshift64*: cheap enough to draw several numbers per loop pass
+struct Rng {
+    uint64_t s;
+    explicit Rng(uint64_t seed) : s(seed * 0x9E3779B97F4A7C15ull + 0x2545F4914F6CDD1Dull) {
+        if (!s) s = 1;
+    }
+    uint32_t next() {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return (uint32_t)((s * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+    // lo..hi inclusive
+    uint32_t range(uint32_t lo, uint32_t hi) { return lo + (uint32_t)((uint64_t)next() * (hi - lo + 1) >> 32); }
+    bool chance(uint32_t oneIn) { return next() % oneIn == 0; }
+};
+
+// Every flag a stage sets while the demo runs; all of them are cleared when a run ends
+static bool SystemState::*const kStageFlags[] = {
+    &SystemState::windOn, &SystemState::solarOn, &SystemState::electricityProductionOn,
+    &SystemState::electrolyserOn, &SystemState::hydrogenTransportOn, &SystemState::hydrogenProductionOn,
+    &SystemState::hydrogenStorageOn, &SystemState::hydrogenStorageFull, &SystemState::h2ConsumptionOn,
+    &SystemState::fabricationOn, &SystemState::electricityTransportOn, &SystemState::storageTransportOn,
+    &SystemState::storagePowerstationOn, &SystemState::streetLightOn, &SystemState::emptyPipe,
+    &SystemState::pipeEmpty, &SystemState::storageDraining, &SystemState::buttonDisabled,
+};
+static const char *const kStageFlagNames[] = {
+    "windOn", "solarOn", "electricityProductionOn", "electrolyserOn", "hydrogenTransportOn",
+    "hydrogenProductionOn", "hydrogenStorageOn", "hydrogenStorageFull", "h2ConsumptionOn", "fabricationOn",
+    "electricityTransportOn", "storageTransportOn", "storagePowerstationOn", "streetLightOn", "emptyPipe",
+    "pipeEmpty", "storageDraining", "buttonDisabled",
+};
+static_assert(sizeof(kStageFlags) / sizeof(kStageFlags[0]) == sizeof(kStageFlagNames) / sizeof(kStageFlagNames[0]),
+              "one name per stage flag");
+
+static const int kEventLog = 8;
+
+// Per-instance driver: button schedule, invariant bookkeeping, recent events
+class Soak {
+public:
+    Soak(Instance &instance, uint64_t seed, const SoakOptions &options)
+        : state(instance.state), timers(instance.timers), rng(seed), seed(seed), options(options) {}
+
+    SoakResult run();
+
+private:
+    void boot();
+    void pass();
+    void scheduleNextPress();
+    bool check();
+    bool fail(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    void logEvent(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    SystemState &state;
+    Timers &timers;
+    Rng rng;
+    const uint64_t seed;
+    const SoakOptions &options;
+    SoakResult result;
+
+    uint64_t elapsed = 0;       // simulated ms since boot (millis() wraps, this does not)
+    uint64_t pressAt = 0;
+    uint64_t releaseAt = 0;
+    uint32_t bounceMs = 0;
+    bool wasActive = false;
+    uint32_t runStart = 0;
+    bool runEnded = false;      // a run has ended; until the next one the relays must stay off
+
+    char events[kEventLog][80];
+    int eventCount = 0;
+};
+
+static std::mutex reportLock;
+
+void Soak::logEvent(const char *format, ...) {
+    char *line = events[eventCount++ % kEventLog];
+    int n = snprintf(line, sizeof(events[0]), "%10llu ms  ", (unsigned long long)elapsed);
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line + n, sizeof(events[0]) - n, format, args);
+    va_end(args);
+}
+
+bool Soak::fail(const char *format, ...) {
+    char message[160];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    std::lock_guard<std::mutex> lock(reportLock);
+    fprintf(stderr, "FAIL seed %llu (profile %s) at %llu ms, millis 0x%08X, pass %llu: %s\n",
+            (unsigned long long)seed, state.profile->name, (unsigned long long)elapsed, millis(),
+            (unsigned long long)result.passes, message);
+    const int first = eventCount > kEventLog ? eventCount - kEventLog : 0;
+    for (int i = first; i < eventCount; ++i) fprintf(stderr, "    %s\n", events[i % kEventLog]);
+    fprintf(stderr, "    rerun: soak --seed %llu --instances 1 --hours %g --step %u%s\n", (unsigned long long)seed,
+            options.hours, options.maxStepMs, options.profile >= 0 ? (" --profile " + std::to_string(options.profile)).c_str() : "");
+    result.failed = true;
+    return false;
+}
+
+void Soak::boot() {
+    // Same order as setup() in main.cpp, minus Serial and the LED test
+    const uint32_t start = rng.chance(2) ? 0u - rng.range(1, RUN_TIME_MS * 4) : rng.next();
+    hostUseVirtualClock(true);
+    hostSetMillis(start);
+    random16_set_seed((uint16_t)rng.next());
+    hostSetPin(BUTTON_PIN, HIGH);
+
+    const int profile = options.profile >= 0 ? options.profile : (int)rng.range(0, kProfileCount - 1);
+    state.profile = &kProfiles[profile];
+    hardwareInit(state);
+    demoCycleBegin(state, timers);
+    state.windOn = true;
+    logEvent("boot, millis 0x%08X", start);
+}
+
+void Soak::scheduleNextPress() {
+    // Gaps: presses while a run is going, presses soon after one ends, long idle stretches
+    uint32_t gap;
+    const uint32_t kind = rng.range(0, 9);
+    if (kind < 3) {
+        gap = rng.range(0, 5000);
+    } else if (kind < 8) {
+        gap = rng.range(5000, RUN_TIME_MS * 2);
+    } else {
+        gap = rng.range(RUN_TIME_MS, 600000);
+    }
+    pressAt = releaseAt + gap;
+    // Mostly a short press; now and then the button is held down for minutes
+    const uint32_t hold = rng.chance(20) ? rng.range(5000, 180000) : rng.range(20, 800);
+    releaseAt = pressAt + hold;
+    bounceMs = rng.chance(3) ? rng.range(1, 30) : 0;
+}
+
+// One pass of loop() in main.cpp (no Serial commands, no idle clip)
+void Soak::pass() {
+    demoCyclePass(state, timers);
+}
+
+bool Soak::check() {
+    const uint32_t now = millis();
+    const int logical = state.profile->logicalLeds;
+
+    // Out-of-range LED writes land in the unused tail or the guard
+    for (int i = logical; i < kMaxLogicalLeds; ++i) {
+        if (state.leds[i] != CRGB::Black) return fail("LED %d lit, profile has %d logical LEDs", i, logical);
+    }
+#if LED_GUARD_PIXELS
+    for (int i = 0; i < LED_GUARD_PIXELS; ++i) {
+        if (state.ledGuard[i] != CRGB::Black) return fail("guard pixel %d behind state.leds lit", i);
+    }
+#endif
+
+    const bool active = state.generalTimerActive;
+    if (active && !wasActive) {
+        ++result.runs;
+        runStart = timers.generalTimerStartTime;
+        runEnded = false;
+        logEvent("run started");
+    }
+    if (active) {
+        const uint32_t running = now - timers.generalTimerStartTime;
+        if (running >= RUN_TIME_MS) return fail("run still active %u ms after it started", running);
+        if (running >= WIND_TIME_MS && hostPinValue(WIND_TURBINE_RELAY_PIN) == HIGH) {
+            return fail("wind relay on %u ms into the run", running);
+        }
+    } else if (wasActive) {
+        logEvent("run ended");
+        runEnded = true;
+        if (now - runStart < RUN_TIME_MS) return fail("run ended after %u ms", now - runStart);
+        for (size_t i = 0; i < sizeof(kStageFlags) / sizeof(kStageFlags[0]); ++i) {
+            if (state.*kStageFlags[i]) return fail("%s still set after the run ended", kStageFlagNames[i]);
+        }
+        for (int i = 0; i < logical; ++i) {
+            if (state.leds[i] != CRGB::Black) return fail("LED %d still lit after the run ended", i);
+        }
+    }
+    if (runEnded) {
+        if (hostPinValue(WIND_TURBINE_RELAY_PIN) == HIGH) return fail("wind relay on while idle");
+        if (hostPinValue(ELECTROLYSER_RELAY_PIN) == HIGH) return fail("electrolyser relay on while idle");
+    }
+    wasActive = active;
+    return true;
+}
+
+SoakResult Soak::run() {
+    boot();
+    releaseAt = 0;
+    scheduleNextPress();
+
+    const uint64_t endMs = (uint64_t)(options.hours * 3600000.0);
+    bool down = false;
+    while (elapsed < endMs) {
+        // Button: held between pressAt and releaseAt, bouncing for the first bounceMs
+        bool pressed = elapsed >= pressAt && elapsed < releaseAt;
+        if (pressed && elapsed < pressAt + bounceMs) pressed = rng.chance(2);
+        if (pressed != down) {
+            hostSetPin(BUTTON_PIN, pressed ? LOW : HIGH);
+            if (pressed && elapsed >= pressAt + bounceMs) {
+                ++result.presses;
+                logEvent("button down (held %llu ms)", (unsigned long long)(releaseAt - pressAt));
+            }
+            down = pressed;
+        }
+        if (elapsed >= releaseAt) scheduleNextPress();
+
+        pass();
+        ++result.passes;
+        if (!check()) break;
+
+        // Loop period: what show() and the effects take on the board, or a stall
+        const uint32_t step = rng.chance(10000) ? rng.range(100, 3000) : rng.range(1, options.maxStepMs);
+        if (millis() + step < millis()) {
+            ++result.wraps;
+            logEvent("millis() wraps");
+        }
+        hostAdvanceMillis(step);
+        elapsed += step;
+    }
+    result.simulatedMs = elapsed;
+    return result;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--hours H] [--instances N] [--threads N] [--seed S] [--step MS] [--profile INDEX]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    SoakOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--hours") && hasValue) {
+            options.hours = atof(argv[++i]);
+        } else if (!strcmp(a, "--instances") && hasValue) {
+            options.instances = atoi(argv[++i]);
+        } else if (!strcmp(a, "--threads") && hasValue) {
+            options.threads = atoi(argv[++i]);
+        } else if (!strcmp(a, "--seed") && hasValue) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(a, "--step") && hasValue) {
+            options.maxStepMs = (uint32_t)atol(argv[++i]);
+        } else if (!strcmp(a, "--profile") && hasValue) {
+            options.profile = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (options.profile >= (int)kProfileCount) {
+        fprintf(stderr, "no profile %d (%u available)\n", options.profile, kProfileCount);
+        return 2;
+    }
+    if (options.maxStepMs < 1 || options.hours <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (options.threads < 1) options.threads = (int)std::thread::hardware_concurrency();
+    if (options.threads < 1) options.threads = 1;
+    if (options.instances < 1) options.instances = options.threads;
+    if (options.threads > options.instances) options.threads = options.instances;
+    if (!getenv("HOST_SERIAL")) setenv("HOST_SERIAL", "/dev/null", 0);
+
+    std::vector<SoakResult> results(options.instances);
+    std::atomic<int> nextInstance(0);
+    const std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+    // Each worker thread runs instances one after another; every instance gets a fresh board
+    std::vector<std::thread> workers;
+    for (int t = 0; t < options.threads; ++t) {
+        workers.push_back(std::thread([&]() {
+            for (int i = nextInstance++; i < options.instances; i = nextInstance++) {
+                Instance *instance = new Instance();
+                Soak soak(*instance, options.seed + (uint64_t)i, options);
+                results[i] = soak.run();
+                delete instance;
+            }
+        }));
+    }
+    for (std::thread &w : workers) w.join();
+
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    SoakResult total;
+    int failed = 0;
+    for (const SoakResult &r : results) {
+        total.passes += r.passes;
+        total.simulatedMs += r.simulatedMs;
+        total.presses += r.presses;
+        total.runs += r.runs;
+        total.wraps += r.wraps;
+        failed += r.failed ? 1 : 0;
+    }
+    printf("%d instances on %d threads: %.1f simulated hours, %llu loop passes in %.1f s (%.2f M passes/s)\n",
+           options.instances, options.threads, total.simulatedMs / 3600000.0, (unsigned long long)total.passes, wall,
+           total.passes / wall / 1e6);
+    printf("%u presses, %u runs, %u millis() wraparounds, %d failed\n", total.presses, total.runs, total.wraps, failed);
+    return failed ? 1 : 0;
+}